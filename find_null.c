@@ -11,27 +11,63 @@
  * Josephine Nguyen, April 2020
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 #include <stdbool.h>
-#include "hashtable.h"
-#include "csv.h"
-#include "csv_data.h"
-#define NULL_NUM 16
+#include <stdint.h>
+#include <glob.h>
+#include <poll.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "nullfinder.h"
+#include "matcher.h"
+#include "batch.h"
+#include "workpool.h"
+#include "dialect.h"
+#include "hugemem.h"
+#include "perfcount.h"
+#define STREAM_MIN_COUNT 0.05f // Decayed freqs below this are dropped in stream mode
+#define BUILTIN_NULLS "builtin" // null_file for null words compiled in (make STATIC_NULLS=file), not read at runtime
+
+#ifdef STATIC_NULLS
+extern const matcher_tables_t static_nulls; // Generated by gen_nulls
+#endif
+
+// How to read input, given by options common to every mode
+typedef struct input_opts {
+	dialect_t dialect; // Given by -F, -Q, -E, -P; defaults for rest
+	bool sniff; // Guess delimiter, quote & encoding from start of data unless one of them given
+	bad_rows_t policy; // What to do w/ rows w/ wrong # fields, given by -r & -q
+	char *quarantine_path; // NULL unless quarantining
+	FILE *quarantine; // Opened once args are all checked
+	hugemem_mode_t pages; // How big tables are backed, given by -H
+	bool prefetch; // Prefetch column slots while counting rows, given by -p
+	size_t memory_limit; // Bytes column tables can take up before spilling to disk, given by -m; 0 if no limit
+} input_opts_t;
 
 int validate_args(int argc, char *argv[]);
-int read_nulls(char *file, char **null_words);
-int read_csv(char *argv[]);
-void on_field_read (void *s, size_t len, void *data);
-void on_row_read (int c, void *data);
-int get_word_count(char *string, size_t len);
-void get_occurrence_probability(void *data, const char *key, void *val);
-void print_probabilities(void *data, const char *key, void *val);
-void find_nulls_by_probabilities(void *data, const char *key, void *val);
-void print_nulls(void *data, const char *key, void *val);
-void get_lowercase(char *string, size_t len);
+matcher_t *load_nulls(char *file);
+bool nulls_readable(char *file);
+int read_csv(char *argv[], input_opts_t *input);
+int run_batch(int argc, char *argv[]);
+int run_stream(int argc, char *argv[]);
+int run_bench(int argc, char *argv[]);
+int bench_once(matcher_t *nulls, char *path, input_opts_t *input, perfcount_t *pc);
+int report_stream(nullfinder_t *nf, bool last);
+void init_input(input_opts_t *input);
+int read_input_opt(char opt, char *val, input_opts_t *input);
+int parse_size(const char *val, size_t *size);
+void long_opts(int argc, char *argv[]);
+int open_input(input_opts_t *input);
+int setup_input(nullfinder_t *nf, input_opts_t *input, const char *sample, size_t len);
+void close_input(input_opts_t *input, nullfinder_t *nf);
+int expand_files(char **args, int args_n, char ***files, int *files_n);
+int add_file(char ***files, int *files_n, int *cap, const char *path);
+void print_nulls(void *data, const char *word);
 
 /* Validates args, reads CSV and prints possible null-equivalent phrases by column #
  * @param argc # args passed
@@ -41,11 +77,38 @@ void get_lowercase(char *string, size_t len);
 int main(int argc, char *argv[])
 {
 	int stat;
+	input_opts_t input;
+	int arg = 1; // 1st arg after any options
+
+	long_opts(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-b") == 0) { // Batch mode has its own args
+		return run_batch(argc, argv);
+	}
+	if (argc > 1 && strcmp(argv[1], "-s") == 0) { // So does stream mode
+		return run_stream(argc, argv);
+	}
+	if (argc > 1 && strcmp(argv[1], "-B") == 0) { // And bench mode
+		return run_bench(argc, argv);
+	}
+	init_input(&input);
+	while (arg+1 < argc && argv[arg][0] == '-' && argv[arg][1] != '\0' && argv[arg][2] == '\0') {
+		if ((stat = read_input_opt(argv[arg][1], argv[arg+1], &input)) != 0) {
+			return stat;
+		}
+		arg += 2;
+	}
+	// Rest of args as if there were no options
+	argv[arg-1] = argv[0];
+	argv += arg-1;
+	argc -= arg-1;
 	if ((stat = validate_args(argc, argv)) != 0) {
 		return stat;
 	}
+	if ((stat = open_input(&input)) != 0) {
+		return stat;
+	}
 	
-	if ((stat = read_csv(argv)) != 0) {
+	if ((stat = read_csv(argv, &input)) != 0) {
 		return stat;
 	}
 
@@ -64,16 +127,19 @@ int validate_args(int argc, char *argv[])
 	int rows_val = 0;
 	int rows_len = 0;
 
-	if (argc != 4) {
-		fprintf(stderr, "Usage: ./find_null null_file csv_file rows_num\n");
+	if (argc != 4 && argc != 5) {
+		fprintf(stderr, "Usage: ./find_null [input_options] null_file csv_file rows_num [threads_num]\n");
+		fprintf(stderr, "       ./find_null -b [-j threads_num] [input_options] null_file csv_file|'glob'|@list_file...\n");
+		fprintf(stderr, "       ./find_null -s [-n rows_num] [-t secs] [-d decay] [input_options] null_file < csv_stream\n");
+		fprintf(stderr, "       ./find_null -B [input_options] null_file csv_file\n");
+		fprintf(stderr, "input_options: [-F delim] [-Q quote] [-E utf8|latin1] [-P strict|lenient] [-r skip|count] [-q quarantine_file]\n");
+		fprintf(stderr, "               [-H off|thp|hugetlb] [-p on|off] [-m|--memory-limit bytes[K|M|G|T]]\n");
 		return 1;
 	}
-	if ((fp = fopen(argv[1], "r")) == NULL) {
+	if (!nulls_readable(argv[1])) {
 		fprintf(stderr, "1st arg must be readable file\n");
 		return 1;
 	}
-	fclose(fp);
-	fp = NULL;
 	if ((fp = fopen(argv[2], "r")) == NULL) {
 		fprintf(stderr, "2nd arg must be readable file\n");
 		return 1;
@@ -83,394 +149,737 @@ int validate_args(int argc, char *argv[])
 		fprintf(stderr, "3rd arg must be valid int\n");
 		return 1;
 	}
+	if (argc == 5 && (sscanf(argv[4], "%d %n", &rows_val, &rows_len) != 1 || rows_len != strlen(argv[4]) || rows_val < 1)) {
+		fprintf(stderr, "4th arg must be valid positive int\n");
+		return 1;
+	}
 
 	return 0;
 }
 
-/* Reads words in file w/ pre-defined null words, puts into char array
+/* Reads null words file & builds matcher from them, or wraps the ones compiled in if file is BUILTIN_NULLS
  * @param file path to null file
- * @param null_words string array we fill up with null words
- * @return exit status
+ * @return matcher or NULL if error
  */
-int read_nulls(char *file, char **null_words)
+matcher_t *load_nulls(char *file)
 {
-	if (file != NULL && null_words != NULL) {
-		FILE *fp; // File we read from
-		int c; // Each char we read from file, one at a time
-		char *word = calloc(50, sizeof(char));
-		*word = '\0'; // Just to be safe
-		int words_idx = 0; // Index in null_words to insert into	
-
-		if ((fp = fopen(file, "r")) == NULL) {
-			return 4;
-		}
-		
-		while ((c = fgetc(fp)) != EOF) {
-			if (c == '\n') { // We've got a null word
-				if (strlen(word) > 0) { // In case multiple whitespaces btwn words
-					*(null_words + words_idx) = word;
-					words_idx++;
-					word = calloc(50, sizeof(char));
-					if (word == NULL) {
-						fclose(fp);
-						return 4;
-					}
-					*word = '\0';
-				}
-			}
-			else { // Still building onto a word
-				int len_so_far = strlen(word);
-				char n = (char) c;
-				// Concatenate to built word w/o strange char at end of each char as with strcat
-				*(word+len_so_far) = n;
-				*(word+len_so_far+1) = '\0';
-			}
-		}
-		free(word); // For extra word allocated just before EOF
-		fclose(fp);
-		return 0;
-		}
-	else {
-		return 2;
+#ifdef STATIC_NULLS
+	if (strcmp(file, BUILTIN_NULLS) == 0) {
+		return matcher_from_tables(&static_nulls);
+	}
+#endif
+	return matcher_load(file);
+}
+
+/* Whether null words can be loaded from file, i.e. it's readable or names null words compiled in
+ * @param file path to null file
+ * @return true if load_nulls can read it
+ */
+bool nulls_readable(char *file)
+{
+	FILE *fp;
+
+#ifdef STATIC_NULLS
+	if (strcmp(file, BUILTIN_NULLS) == 0) {
+		return true;
+	}
+#endif
+	if ((fp = fopen(file, "r")) == NULL) {
+		return false;
 	}
+	fclose(fp);
+	return true;
 }
 
-/* Reads, processes CSV, prints potential null words by column #
- * Calls read_nulls to get array of defined null-equivalent words first
- * @param argv same as main
+/* Reads CSV, feeding it through null finder library, prints potential null words by column #
+ * Calls load_nulls to get matcher for defined null-equivalent words first
+ * @param argv same as main, w/o options
+ * @param input how to read csv, quarantine file opened already if any
  * @return exit status
  */
-int read_csv(char *argv[])
+int read_csv(char *argv[], input_opts_t *input)
 {
-	char **null_words; // Array to fill up w/ defined null words
+	matcher_t *nulls; // Built from defined null words
 	FILE *fp; // CSV
-	char line[5120]; // Buffer for each line read from CSV file
-	struct csv_parser csv_obj; // Parser for csvlib
-	csv_data_t *csv_info; // Holds hashtables of values in columns, null values in columns, other info about csv
-	size_t bytes_read; // For csvlib, make sure no error in read
-	float **avg_probabilities; // Array of floats representing avg probability w/ which unique words show up in each col
-	hashtable_t **column_to_nulls; // Hashtable array of null words in every column (every item is hashtable of present null words) 
-	hashtable_t **columns; // Hashtable of array of unique words in every column (every item is hashtable of word as key, probability at which they occur as value)
+	char line[SNIFF_SIZE]; // Buffer for each chunk read from CSV file, 1st one's enough to guess dialect from
+	size_t bytes_read; // # bytes in buffer
+	nullfinder_t *nf; // Does all the work
+	struct stat st; // To see if CSV can be read in pieces
+	int stat = 0;
 	
 	// Read from file of pre-defined null words
-	null_words = calloc(NULL_NUM, sizeof(char*));
-	if (null_words == NULL) {
+	if ((nulls = load_nulls(argv[1])) == NULL) {
 		return 4;
 	}
-	read_nulls(argv[1], null_words);
 	
 	/* Read from csv */
 	
-	// Get rows num provided by user, add to struct of csv info
+	// Get rows num provided by user
 	char* rem;
 	int rows = (int)strtol(argv[3], &rem, 10);
-	csv_info = csv_data_new(null_words, rows);
-	if (csv_info == NULL) {
+	int threads = workpool_default_threads();
+	if ((nf = nullfinder_new_shared(nulls, rows)) == NULL) {
 		return 4;
 	}
-	
-	// Initialize csv parser
-	if (csv_init(&csv_obj, 0) != 0) {
-		return 4;
+	if (argv[4] != NULL) {
+		threads = (int)strtol(argv[4], &rem, 10);
+		nullfinder_set_threads(nf, threads);
 	}
 	
-	// Open file, read line by line, calling callback functions w/ every field & row read
-	// to populate hashtables of words in each column & null words in each column
+	// Open file, read chunk by chunk, handing every chunk to null finder
 	if ((fp = fopen(argv[2], "r")) == NULL) {
 		return 4;
 	}
-	while ((bytes_read = fread(line, sizeof(char), 5120, fp)) > 0) {
-		if (csv_parse(&csv_obj, line, bytes_read, on_field_read, on_row_read, csv_info) != bytes_read) {
+	bytes_read = fread(line, sizeof(char), SNIFF_SIZE, fp);
+	if ((stat = setup_input(nf, input, line, bytes_read)) != 0) {
+		return stat;
+	}
+	if (threads > 1 && fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode)) { // Pieces of file parsed in parallel
+		if ((stat = batch_read_file(nf, nulls, argv[2], threads, &input->dialect, input->policy, input->quarantine, input->prefetch, input->memory_limit)) != 0) {
 			fprintf(stderr, "Error parsing.\n");
-			return 4;
+			return stat;
 		}
+		bytes_read = 0;
 	}
-	
-	// Calculate avg probability w/ which words occur in each col
-	avg_probabilities = csv_data_avg_probabilities_new(csv_info);
-	/*for (int i = 0; i < csv_data_get_cols_n(csv_info); i++) {
-		printf("%d %f\n", i, **(avg_probabilities+i));
-	}*/
-	
-	// Get ref to hashtable arrays
-	column_to_nulls = csv_data_get_column_to_nulls(csv_info);
-	if (column_to_nulls == NULL) {
-		return 4;
-	}
-	columns = csv_data_get_columns(csv_info);
-	if (columns == NULL) {
-		return 4;
+	for (; bytes_read > 0; bytes_read = fread(line, sizeof(char), SNIFF_SIZE, fp)) {
+		if (nullfinder_feed(nf, line, bytes_read) != 0) {
+			fprintf(stderr, "Error parsing.\n");
+			return 4;
+		}
 	}
-
-	/*for (int i = 0; i < csv_data_get_cols_n(csv_info); i++) {
-		hashtable_print(*(columns+i));
-	}*/
 	
-	// Loop through all hashtables in columns to divide freq of a unique word by total rows to get probability
-	// Then add any new null words detected by probability to column_to_nulls
-	for (int i = 0; i < csv_data_get_cols_n(csv_info); i++) {
-		csv_data_set_col_curr(csv_info, i); // So in find_nulls_by_probabilities, know which array item to insert
-		hashtable_iterate(*(columns+i), &rows, get_occurrence_probability);
-		hashtable_iterate(*(columns+i), csv_info, find_nulls_by_probabilities);
-		//hashtable_iterate(*(columns+i), NULL, print_probabilities);
+	// Columns are finished off in parallel
+	if ((stat = nullfinder_finalize(nf)) != 0) {
+		return stat;
 	}
 	
 	// Print results
-	for (int i = 0; i < csv_data_get_cols_n(csv_info); i++) {
+	for (int i = 0; i < nullfinder_get_cols_n(nf); i++) {
 		printf("COLUMN %d: \n", i+1);
-		hashtable_iterate(*(column_to_nulls+i), NULL, print_nulls);	
+		nullfinder_iterate(nf, i, NULL, print_nulls);
 		printf("\n");
 	}
 	
 	// Clean up
-	csv_fini(&csv_obj, on_field_read, on_row_read, csv_info);
-	csv_free(&csv_obj);
+	close_input(input, nf);
+	nullfinder_free(nf);
 	fclose(fp);
-	for (int i = 0; i < NULL_NUM; i++) {
-		free(null_words[i]);
+	matcher_free(nulls);
+
+	return 0;
+}
+
+/* Batch mode: validates batch args, finds null words in every csv file given, prints one report
+ * @param argc as in main
+ * @param argv as in main, argv[1] is -b
+ * @return exit status
+ */
+int run_batch(int argc, char *argv[])
+{
+	int threads = workpool_default_threads();
+	int arg = 2; // Next arg to look at
+	int threads_len = 0;
+	char **files = NULL; // Every csv file, once lists & globs expanded
+	int files_n = 0;
+	matcher_t *nulls;
+	input_opts_t input;
+	int stat;
+
+	init_input(&input);
+	while (arg+1 < argc && argv[arg][0] == '-' && argv[arg][1] != '\0' && argv[arg][2] == '\0') {
+		if (argv[arg][1] == 'j') {
+			if (sscanf(argv[arg+1], "%d %n", &threads, &threads_len) != 1 || threads_len != strlen(argv[arg+1]) || threads < 1) {
+				fprintf(stderr, "-j must be followed by valid positive int\n");
+				return 1;
+			}
+		}
+		else if ((stat = read_input_opt(argv[arg][1], argv[arg+1], &input)) != 0) {
+			return stat;
+		}
+		arg += 2;
+	}
+	if (argc - arg < 2) {
+		fprintf(stderr, "Usage: ./find_null -b [-j threads_num] [input_options] null_file csv_file|'glob'|@list_file...\n");
+		return 1;
 	}
-	free(null_words);
-	for (int i = 0; i < csv_data_get_cols_n(csv_info); i++) {
-		hashtable_free(*(column_to_nulls+i));
+	if (!nulls_readable(argv[arg])) {
+		fprintf(stderr, "null_file must be readable file\n");
+		return 1;
 	}
-	free(column_to_nulls);
-	for (int i = 0; i < csv_data_get_cols_n(csv_info); i++) {
-		hashtable_free(*(columns+i));
+	if ((stat = expand_files(argv+arg+1, argc-arg-1, &files, &files_n)) != 0) {
+		fprintf(stderr, "Can't expand csv files\n");
+		return stat;
 	}
-	for (int i = 0; i < csv_data_get_cols_n(csv_info); i++) {
-		free(*(avg_probabilities+i));
+
+	if ((stat = open_input(&input)) != 0) {
+		return stat;
 	}
-	free(avg_probabilities);
-	free(columns);
-	free(csv_info);
 
-	return 0;
+	// Null words matcher built once for every file
+	if ((nulls = load_nulls(argv[arg])) == NULL) {
+		return 4;
+	}
+	stat = batch_run(nulls, files, files_n, threads, &input.dialect, input.sniff, input.policy, input.quarantine, input.prefetch, input.memory_limit, stdout);
+
+	close_input(&input, NULL); // Summary per file already printed
+	matcher_free(nulls);
+	for (int i = 0; i < files_n; i++) {
+		free(files[i]);
+	}
+	free(files);
+	return stat;
 }
 
-/* Prints a single null word in a hashtable in an iterate function
- * @param data expect NULL
- * @param key the null word
- * @param val expect dummy item, not NULL but meaningless
+/* Stream mode: reads csv from stdin as it comes in, printing updated report every rows_num rows
+ * and/or every secs seconds, & a last one at end of stream
+ * If decay given, freqs are scaled down by it after every report so older rows fade out,
+ * which also keeps memory bounded however long stream runs
+ * @param argc as in main
+ * @param argv as in main, argv[1] is -s
+ * @return exit status
  */
-void print_nulls(void *data, const char *key, void *val)
+int run_stream(int argc, char *argv[])
 {
-	if (key != NULL) {
-		printf("%s, ", key);
+	int every_rows = 0; // 0 if not reporting by rows
+	double every_secs = 0; // 0 if not reporting by time
+	float decay = 1;
+	int arg = 2; // Next arg to look at
+	int len = 0;
+	matcher_t *nulls;
+	nullfinder_t *nf;
+	char buf[5120]; // Buffer for each chunk read from stdin
+	ssize_t bytes_read;
+	int next_rows; // Rows read at which next report's due
+	struct timespec last, now; // When last report was printed, & now
+	input_opts_t input;
+	bool started = false; // Whether input's been set up, once 1st data comes in
+	int stat = 0;
+
+	init_input(&input);
+	while (arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0' && argv[arg][2] == '\0') {
+		char opt = argv[arg][1];
+		bool ok = arg+1 < argc;
+
+		if (ok && opt == 'n') {
+			ok = sscanf(argv[arg+1], "%d %n", &every_rows, &len) == 1 && len == strlen(argv[arg+1]) && every_rows > 0;
+		}
+		else if (ok && opt == 't') {
+			ok = sscanf(argv[arg+1], "%lf %n", &every_secs, &len) == 1 && len == strlen(argv[arg+1]) && every_secs > 0;
+		}
+		else if (ok && opt == 'd') {
+			ok = sscanf(argv[arg+1], "%f %n", &decay, &len) == 1 && len == strlen(argv[arg+1]) && decay > 0 && decay <= 1;
+		}
+		else if (ok && strchr("FQEPrqHpm", opt) != NULL) {
+			if ((stat = read_input_opt(opt, argv[arg+1], &input)) != 0) {
+				return stat;
+			}
+		}
+		else {
+			ok = false;
+		}
+		if (!ok) {
+			fprintf(stderr, "-n must be followed by valid positive int, -t by positive secs, -d by decay in (0, 1]\n");
+			return 1;
+		}
+		arg += 2;
+	}
+	if (argc - arg != 1) {
+		fprintf(stderr, "Usage: ./find_null -s [-n rows_num] [-t secs] [-d decay] [input_options] null_file < csv_stream\n");
+		return 1;
+	}
+	if (!nulls_readable(argv[arg])) {
+		fprintf(stderr, "null_file must be readable file\n");
+		return 1;
+	}
+	if ((stat = open_input(&input)) != 0) {
+		return stat;
+	}
+
+	// Rows # not known up front, so left to null finder to count
+	if ((nulls = load_nulls(argv[arg])) == NULL) {
+		return 4;
+	}
+	if ((nf = nullfinder_new_shared(nulls, 0)) == NULL) {
+		matcher_free(nulls);
+		return 4;
+	}
+
+	next_rows = every_rows;
+	clock_gettime(CLOCK_MONOTONIC, &last);
+	while (stat == 0) {
+		struct pollfd in = {STDIN_FILENO, POLLIN, 0};
+		int timeout = -1; // Wait as long as it takes for more input, unless report due by time
+
+		if (every_secs > 0) {
+			double waited;
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			waited = (now.tv_sec - last.tv_sec) + (now.tv_nsec - last.tv_nsec) / 1e9;
+			timeout = (waited >= every_secs) ? 0 : (int)((every_secs - waited) * 1000) + 1;
+		}
+		if (poll(&in, 1, timeout) < 0) {
+			stat = 4;
+			break;
+		}
+		if (in.revents != 0) { // Something to read, or end of stream
+			if ((bytes_read = read(STDIN_FILENO, buf, sizeof(buf))) <= 0) {
+				break;
+			}
+			if (!started) { // Dialect guessed from whatever comes in 1st
+				if ((stat = setup_input(nf, &input, buf, bytes_read)) != 0) {
+					break;
+				}
+				started = true;
+			}
+			if (nullfinder_feed(nf, buf, bytes_read) != 0) {
+				fprintf(stderr, "Error parsing.\n");
+				stat = 4;
+				break;
+			}
+		}
+
+		// Report if due by rows or time
+		bool due = every_rows > 0 && nullfinder_get_rows_read(nf) >= next_rows;
+		if (every_secs > 0) {
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			due = due || (now.tv_sec - last.tv_sec) + (now.tv_nsec - last.tv_nsec) / 1e9 >= every_secs;
+		}
+		if (due) {
+			if ((stat = report_stream(nf, false)) != 0) {
+				break;
+			}
+			while (every_rows > 0 && next_rows <= nullfinder_get_rows_read(nf)) {
+				next_rows += every_rows;
+			}
+			clock_gettime(CLOCK_MONOTONIC, &last);
+			if (decay < 1) {
+				stat = nullfinder_decay(nf, decay, STREAM_MIN_COUNT);
+			}
+		}
 	}
+
+	// Last report covers whatever's left
+	if (stat == 0 && (stat = nullfinder_finalize(nf)) == 0) {
+		stat = report_stream(nf, true);
+	}
+	close_input(&input, nf);
+	nullfinder_free(nf);
+	matcher_free(nulls);
+	return stat;
 }
 
-/* Detects null words, determined as words w/ low enough probabilities of showing up in that col
- * then adds words to column_to_nulls
- * @param data csv_data_t ptr, holding the 2 important hashtable arrays
- * @param key current word we're determining whether null
- * @val word's probability
+/* Bench mode: analyzes csv file w/ & w/o huge pages & prefetching, printing time & cache/TLB misses per cell
+ * (cells = rows read * cols) for each, so it's easy to see what they buy on a given file & machine
+ * Huge pages compared are those given by -H (thp if none or off), -p is ignored since both ways are run
+ * @param argc as in main
+ * @param argv as in main, argv[1] is -B
+ * @return exit status
  */
-void find_nulls_by_probabilities(void *data, const char *key, void *val)
+int run_bench(int argc, char *argv[])
 {
-	if (data != NULL && key != NULL && val != NULL) {
-		csv_data_t *info = (csv_data_t *)data;
-		hashtable_t *column_nulls = *(csv_data_get_column_to_nulls(info) + csv_data_get_col_curr(info));
-		float *avg = *(csv_data_get_avg_probabilities(info) + csv_data_get_col_curr(info));
-		float *prob = (float *)val;
-		char *field_cp = (char *)key;
-		
-		// Probability sufficiently less than avg probability in col, and word isn't too long in terms of length & word #
-		if (((*avg < 0.5 && *prob <= *avg * 0.02) || (*avg >= 0.5 && *prob < *avg * 0.02)) && get_word_count(field_cp, strlen(field_cp)) <= 3 && strlen(field_cp) < 10)  {
-			/*if (csv_data_get_col_curr(info)+1 == 11) {
-				printf("key: %s prob: %f avg: %f\n", field_cp, *prob, *avg);
-			}*/
-
-			char *dummy = malloc(sizeof(char)); // Dummy value item for inserting new null word detected
-			char *key_cp = calloc(strlen(key)+1, sizeof(char));
-			strcpy(key_cp, key);
-			if (hashtable_insert(column_nulls, key_cp, dummy) != 0) { // Clean up if can't insert e.g. already detected w/ pre-defined null words
-				free(dummy);
-				free(key_cp);
-			}
+	const char *pages_names[] = {"off", "thp", "hugetlb"};
+	hugemem_mode_t pages[2] = {HUGEMEM_OFF, HUGEMEM_THP};
+	int arg = 2; // Next arg to look at
+	FILE *fp;
+	char buf[SNIFF_SIZE];
+	matcher_t *nulls;
+	perfcount_t *pc;
+	input_opts_t input;
+	int stat = 0;
+
+	init_input(&input);
+	while (arg+1 < argc && argv[arg][0] == '-' && argv[arg][1] != '\0' && argv[arg][2] == '\0') {
+		if ((stat = read_input_opt(argv[arg][1], argv[arg+1], &input)) != 0) {
+			return stat;
 		}
+		arg += 2;
+	}
+	if (argc - arg != 2) {
+		fprintf(stderr, "Usage: ./find_null -B [input_options] null_file csv_file\n");
+		return 1;
+	}
+	if (!nulls_readable(argv[arg])) {
+		fprintf(stderr, "null_file must be readable file\n");
+		return 1;
+	}
+	if ((fp = fopen(argv[arg+1], "r")) == NULL) {
+		fprintf(stderr, "csv_file must be readable file\n");
+		return 1;
+	}
+	// Read through once untimed, so 1st run doesn't pay for disk
+	while (fread(buf, sizeof(char), SNIFF_SIZE, fp) > 0);
+	fclose(fp);
+	if (input.pages != HUGEMEM_OFF) {
+		pages[1] = input.pages;
+	}
+	if ((stat = open_input(&input)) != 0) {
+		return stat;
 	}
+
+	if ((nulls = load_nulls(argv[arg])) == NULL) {
+		return 4;
+	}
+	if ((pc = perfcount_new()) == NULL) {
+		matcher_free(nulls);
+		return 4;
+	}
+	printf("%-8s %-8s %12s %10s %14s %14s\n", "pages", "prefetch", "cells", "secs", "misses/cell", "dTLB/cell");
+	for (int i = 0; i < 4 && stat == 0; i++) {
+		hugemem_set_mode(pages[i / 2]);
+		input.prefetch = (i % 2 == 1);
+		printf("%-8s %-8s ", pages_names[pages[i / 2]], input.prefetch ? "on" : "off");
+		stat = bench_once(nulls, argv[arg+1], &input, pc);
+	}
+
+	close_input(&input, NULL);
+	perfcount_free(pc);
+	matcher_free(nulls);
+	return stat;
 }
 
-/* Print probability of each word in col, for testing
- * @param data expect NULL
- * @param key word
- * @param val probability
+/* Analyzes csv file once on a single thread, printing rest of its bench line
+ * @param nulls matcher built from null words
+ * @param path csv file
+ * @param input how to read csv, w/ prefetching set for this run
+ * @param pc counters to count misses w/
+ * @return exit status
  */
-void print_probabilities(void *data, const char *key, void *val)
+int bench_once(matcher_t *nulls, char *path, input_opts_t *input, perfcount_t *pc)
 {
-	if (key != NULL && val != NULL) {
-		printf("%s : %f\n", (char *)key, *((float *)val));
+	FILE *fp;
+	char buf[SNIFF_SIZE];
+	size_t bytes_read;
+	nullfinder_t *nf;
+	struct timespec start, end;
+	int stat = 0;
+
+	if ((fp = fopen(path, "r")) == NULL) {
+		return 4;
+	}
+	if ((nf = nullfinder_new_shared(nulls, 0)) == NULL) {
+		fclose(fp);
+		return 4;
+	}
+	nullfinder_set_threads(nf, 1); // Misses counted are all from tables, not threads fighting over cache
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	perfcount_start(pc);
+	bytes_read = fread(buf, sizeof(char), SNIFF_SIZE, fp);
+	stat = setup_input(nf, input, buf, bytes_read);
+	for (; stat == 0 && bytes_read > 0; bytes_read = fread(buf, sizeof(char), SNIFF_SIZE, fp)) {
+		if (nullfinder_feed(nf, buf, bytes_read) != 0) {
+			fprintf(stderr, "Error parsing.\n");
+			stat = 4;
+		}
+	}
+	if (stat == 0) {
+		stat = nullfinder_finalize(nf);
+	}
+	perfcount_stop(pc);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	if (stat == 0) {
+		double cells = (double)nullfinder_get_rows_read(nf) * nullfinder_get_cols_n(nf);
+		printf("%12.0f %10.3f", cells, (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+		for (int i = 0; i < PERFCOUNT_EVENTS_N; i++) {
+			long long misses = perfcount_get(pc, (perfcount_event_t)i);
+			if (misses < 0 || cells == 0) {
+				printf(" %14s", "n/a");
+			}
+			else {
+				printf(" %14.4f", misses / cells);
+			}
+		}
+		printf("\n");
 	}
+	nullfinder_free(nf);
+	fclose(fp);
+	return stat;
 }
 
-/* Calculate occurrence probability of a word in a col
- * @param data total rows in csv
- * @param key word
- * @param val initially frequency, we change to probability in function
+/* Prints report of null words found so far in stream
+ * @param nf null finder fed w/ stream
+ * @param last whether stream's ended (& nf finalized)
+ * @return exit status
  */
-void get_occurrence_probability(void *data, const char *key, void *val)
+int report_stream(nullfinder_t *nf, bool last)
 {
-	if (data != NULL && val != NULL) {
-		int *total = (int *)data;
-		float *prob = (float *)val;
-		*(prob) = *(prob) / (float)(*(total));
+	int stat;
+
+	if (!last && (stat = nullfinder_evaluate(nf)) != 0) {
+		return stat;
+	}
+	printf("REPORT after %d rows%s:\n", nullfinder_get_rows_read(nf), last ? " (end of stream)" : "");
+	for (int i = 0; i < nullfinder_get_cols_n(nf); i++) {
+		printf("COLUMN %d: \n", i+1);
+		nullfinder_iterate(nf, i, NULL, print_nulls);
+		printf("\n");
 	}
+	printf("\n");
+	fflush(stdout);
+	return 0;
 }
 
-/* Callback function every time we finish reading a field
- * @param s field string
- * @param len length of field string
- * @data csv_data_t* ptr, holding other csv info -- update data structures in struct here
+/* Sets input options to defaults: guessed dialect, rows w/ wrong # fields counted, transparent huge pages, no prefetching,
+ * no memory limit
+ * @param input options to set
  */
-void on_field_read (void *s, size_t len, void *data)
+void init_input(input_opts_t *input)
 {
-	csv_data_t *info = (csv_data_t*)data;
-	csv_data_set_col_curr(info, csv_data_get_col_curr(info)+1); // For reference later, we know which column we're on
-	
-	if (csv_data_get_cols_n(info) == 0) {return;} // The rest is for 2nd+ rows
-	
-	char *s_char = (char *)s; // For rebuilding s
-	char *field = calloc((len+1), sizeof(char)); // s isn't completely sanitized, so just rebuild our own s
-	int len_so_far = 0; // For rebuilding s
-	char **null_words; // Get from csv info
-	hashtable_t **column_to_nulls; // Get from csv info
-	hashtable_t **columns; // Get from csv info
-	
-	// Build s as field
-	while (len) {
-		len_so_far = strlen(field);
-		*(field+len_so_far) = *(s_char);
-		*(field+len_so_far+1) = '\0';
-		s_char++;
-		len--;
-	}
-	
-	char *field_cp = calloc(strlen(field)+1, sizeof(char)); // Potentially insert into both columns & column_to_nulls so need 2 separate refs
-	strcpy(field_cp, field);
+	dialect_default(&input->dialect);
+	input->sniff = true;
+	input->policy = BAD_ROWS_COUNT;
+	input->quarantine_path = NULL;
+	input->quarantine = NULL;
+	input->pages = HUGEMEM_THP;
+	input->prefetch = false;
+	input->memory_limit = 0;
+}
 
-	null_words = csv_data_get_nulls(info);
-	column_to_nulls = csv_data_get_column_to_nulls(info);
-	columns = csv_data_get_columns(info);
-	
-	/* Insert into columns */
-	float *count = malloc(sizeof(int)); // Item which we insert in, if never seen word before
-	*count = 1;
-	int stat = 0; // Track status see if successful insert
-	if ((stat = hashtable_insert(*(columns+csv_data_get_col_curr(info)-1), field, count)) == 3) { // Repeated item
-		free(count);
-		count = NULL;
-		count = (hashtable_find(*(columns+csv_data_get_col_curr(info)-1), field));
-		if (count != NULL) {
-			++*(count); // Increment existing freq
+/* Reads an input option: -F delim, -Q quote, -E encoding, -P strict|lenient, -r skip|count,
+ * -q quarantine_file (leaves rows w/ wrong # fields out, writing them there), -H off|thp|hugetlb (huge pages for big tables),
+ * -p on|off (prefetch column slots), or -m bytes (memory limit for column tables, w/ optional K, M, G or T suffix)
+ * @param opt option letter
+ * @param val arg after option
+ * @param input options read so far, updated
+ * @return exit status
+ */
+int read_input_opt(char opt, char *val, input_opts_t *input)
+{
+	if (opt == 'F' || opt == 'Q' || opt == 'E' || opt == 'P') {
+		if (dialect_parse_opt(opt, val, &input->dialect) != 0) {
+			fprintf(stderr, "Invalid -%c %s (-F must be followed by delimiter char or tab|comma|semicolon|pipe|space, "
+				"-Q by quote char, -E by utf8|latin1, -P by strict|lenient)\n", opt, val);
+			return 1;
+		}
+		if (opt != 'P') { // Anything guessable given outright, so go w/ what's given
+			input->sniff = false;
 		}
-		free(field);
 	}
-	else if (stat == 4) { // Some malloc error, just clean up
-		free(field);
-		free(count);
+	else if (opt == 'r' && strcmp(val, "skip") == 0) {
+		input->policy = BAD_ROWS_SKIP;
 	}
-	
-	char *field_lc = calloc(strlen(field_cp)+1, sizeof(char));
-	strcpy(field_lc, field_cp);
-	get_lowercase(field_lc, strlen(field_lc));	
-	/* Insert into column_to_nulls */
-	for (int i = 0; i < NULL_NUM; i++) {
-		char *curr = *(null_words+i); // Current pre-defined null word
-		// Current null word is substring of field, word is short enough (word # and string length) absolutely & relatively compared to null word
-		if (strstr(field_lc, curr) != NULL && get_word_count(field_cp, strlen(field_cp)) <= 3 && strlen(field_cp) < 10 && strlen(field_cp) < (strlen(curr) * 2)) {
-			char *dummy = malloc(sizeof(char));
-		
-			if (hashtable_insert(*(column_to_nulls+csv_data_get_col_curr(info)-1), field_cp, dummy) == 0) {
-				free(field_lc);
-				return;
-			}
-			else { // Clean up if unsuccessful
-				free(dummy);
-			}
+	else if (opt == 'r' && strcmp(val, "count") == 0) {
+		input->policy = BAD_ROWS_COUNT;
+	}
+	else if (opt == 'q') {
+		input->policy = BAD_ROWS_QUARANTINE;
+		input->quarantine_path = val;
+	}
+	else if (opt == 'H') {
+		if (hugemem_parse_mode(val, &input->pages) != 0) {
+			fprintf(stderr, "Invalid -H %s (-H must be followed by off|thp|hugetlb)\n", val);
+			return 1;
+		}
+	}
+	else if (opt == 'm') {
+		if (parse_size(val, &input->memory_limit) != 0) {
+			fprintf(stderr, "Invalid -m %s (-m must be followed by positive # bytes, w/ optional K, M, G or T suffix)\n", val);
+			return 1;
 		}
 	}
+	else if (opt == 'p' && (strcmp(val, "on") == 0 || strcmp(val, "off") == 0)) {
+		input->prefetch = (strcmp(val, "on") == 0);
+	}
+	else {
+		fprintf(stderr, "Unknown option -%c %s (-r must be followed by skip or count, -q by quarantine file, -p by on|off)\n", opt, val);
+		return 1;
+	}
+	return 0;
+}
+
+/* Reads a size in bytes, e.g. 64G
+ * @param val # bytes, w/ optional K, M, G or T suffix (powers of 1024)
+ * @param size filled in
+ * @return exit status
+ */
+int parse_size(const char *val, size_t *size)
+{
+	const char *units = "KMGT";
+	double n;
+	int len = 0;
+	char *unit;
 
-	// Alternatively, if field is empty, this may be considered null, represented by <empty>
-	if (strlen(field_cp) == 0) {
-		char *empty = calloc(8, sizeof(char));
-		strcpy(empty, "<empty>");
-		char *dummy = malloc(sizeof(char));
-		if (hashtable_insert(*(column_to_nulls+csv_data_get_col_curr(info)-1), empty, dummy) != 0) {
-			free(empty);
-			free(dummy);
+	if (sscanf(val, "%lf%n", &n, &len) != 1 || n <= 0) {
+		return 1;
+	}
+	if (val[len] != '\0') {
+		if (val[len+1] != '\0' || (unit = strchr(units, val[len])) == NULL) {
+			return 1;
 		}
+		for (long i = 0; i <= unit - units; i++) {
+			n *= 1024;
+		}
+	}
+	if (n < 1 || n > (double)SIZE_MAX) {
+		return 1;
 	}
-	free(field_lc);
-	free(field_cp);
+	*size = (size_t)n;
+	return 0;
 }
 
-/* Callback function every time we finish reading a row
- * @param c current char processed by csvlib
- * @param data csv_data_t*, holds data about csv
+/* Turns long options into their short forms in place, so every mode reads them the same (--memory-limit is -m)
+ * @param argc as in main
+ * @param argv as in main
  */
-void on_row_read (int c, void *data)
-{ 
-	hashtable_t **column_to_nulls;
-	hashtable_t **columns;
-	csv_data_t *info = (csv_data_t*)data;
-
-	if (csv_data_get_cols_n(info) == 0) { // Only true after read first row
-		if (csv_data_set_cols_n(info, csv_data_get_col_curr(info)) == csv_data_get_col_curr(info)) { // Set total col number in csv info struct
-			// Set up columns & column_to_nulls; both initially empty
-			if ((columns = csv_data_new_columns(info)) == NULL) {
-				fprintf(stderr, "Malloc error\n");
-				return;
-			}
+void long_opts(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--memory-limit") == 0) {
+			argv[i] = "-m";
+		}
+	}
+}
 
-			for (int i = 0; i < csv_data_get_cols_n(info); i++) {
-				if ((*(columns+i) = hashtable_new(csv_data_get_rows_n(info) * 2)) == NULL) {
-					fprintf(stderr, "Malloc error for columns\n");
-					return;
-				}
-			}
+/* Opens quarantine file if quarantining, sets how big tables are backed
+ * @param input options read from args
+ * @return exit status
+ */
+int open_input(input_opts_t *input)
+{
+	hugemem_set_mode(input->pages);
+	if (input->policy == BAD_ROWS_QUARANTINE && (input->quarantine = fopen(input->quarantine_path, "w")) == NULL) {
+		fprintf(stderr, "quarantine_file must be writable file\n");
+		return 1;
+	}
+	return 0;
+}
 
-			if ((column_to_nulls = csv_data_new_column_to_nulls(info)) == NULL) {
-				fprintf(stderr, "Malloc error\n");
-				return;
-			}
+/* Sets up null finder to read input as options say, guessing dialect from start of data if need be
+ * @param nf null finder, nothing fed yet
+ * @param input options read from args
+ * @param sample start of data
+ * @param len # bytes in sample
+ * @return exit status
+ */
+int setup_input(nullfinder_t *nf, input_opts_t *input, const char *sample, size_t len)
+{
+	int stat;
 
-			for (int i = 0; i < csv_data_get_cols_n(info); i++) {
-				if ((*(column_to_nulls+i) = hashtable_new(csv_data_get_rows_n(info) * 2)) == NULL) {
-					fprintf(stderr, "Malloc error for column_to_nulls\n");
-					return;
+	if (input->sniff) {
+		dialect_sniff(sample, len, &input->dialect);
+	}
+	if ((stat = nullfinder_set_dialect(nf, &input->dialect)) != 0) {
+		fprintf(stderr, "Delimiter & quote must be different\n");
+		return stat;
+	}
+	if ((stat = nullfinder_set_prefetch(nf, input->prefetch)) != 0) {
+		return stat;
+	}
+	if ((stat = nullfinder_set_memory_limit(nf, input->memory_limit)) != 0) {
+		return stat;
+	}
+	return nullfinder_set_bad_rows(nf, input->policy, input->quarantine);
+}
+
+/* Prints summary of rows w/ wrong # fields & parse errors to stderr if there were any, closes quarantine file
+ * @param input options read from args
+ * @param nf null finder done w/ reading, NULL if summary printed elsewhere
+ */
+void close_input(input_opts_t *input, nullfinder_t *nf)
+{
+	if (nf != NULL && (nullfinder_get_bad_rows(nf) > 0 || nullfinder_get_parse_errors(nf) > 0)) {
+		fprintf(stderr, "%d rows w/ wrong # fields (%s), %d parse errors (%ld bytes skipped)\n", nullfinder_get_bad_rows(nf),
+			(input->policy == BAD_ROWS_COUNT) ? "counted" : "left out", nullfinder_get_parse_errors(nf), nullfinder_get_skipped(nf));
+	}
+	if (input->quarantine != NULL) {
+		fclose(input->quarantine);
+		input->quarantine = NULL;
+	}
+}
+
+/* Turns csv file args into list of paths: @list_file is replaced by paths in it (one per line),
+ * an arg w/ wildcards is replaced by files matching it, anything else is taken as is
+ * @param args csv file args
+ * @param args_n # args
+ * @param files filled in w/ new array of paths
+ * @param files_n filled in w/ # paths
+ * @return exit status
+ */
+int expand_files(char **args, int args_n, char ***files, int *files_n)
+{
+	int cap = 0;
+
+	*files = NULL;
+	*files_n = 0;
+	for (int i = 0; i < args_n; i++) {
+		if (args[i][0] == '@') {
+			FILE *fp;
+			char *line = NULL;
+			size_t line_cap = 0;
+			ssize_t len;
+
+			if ((fp = fopen(args[i]+1, "r")) == NULL) {
+				return 1;
+			}
+			while ((len = getline(&line, &line_cap, fp)) != -1) {
+				while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) {
+					line[--len] = '\0';
+				}
+				if (len > 0 && add_file(files, files_n, &cap, line) != 0) {
+					free(line);
+					fclose(fp);
+					return 4;
 				}
 			}
+			free(line);
+			fclose(fp);
+		}
+		else if (strpbrk(args[i], "*?[") != NULL) {
+			glob_t matches;
 
+			if (glob(args[i], 0, NULL, &matches) == 0) {
+				for (size_t j = 0; j < matches.gl_pathc; j++) {
+					if (add_file(files, files_n, &cap, matches.gl_pathv[j]) != 0) {
+						globfree(&matches);
+						return 4;
+					}
+				}
+			}
+			else if (add_file(files, files_n, &cap, args[i]) != 0) { // No match, keep it so it's reported
+				return 4;
+			}
+			globfree(&matches);
+		}
+		else if (add_file(files, files_n, &cap, args[i]) != 0) {
+			return 4;
 		}
 	}
-	csv_data_set_col_curr(info, 0); // Reset current column processing to 0 every time finish a row
+	return 0;
 }
 
-/* Calculates how many words in a string based on number of whitespace
- * @param string word
- * @param len length of word
- * @return number of words
+/* Appends copy of a path to array of paths, making room if needed
+ * @param files array of paths
+ * @param files_n # paths in array
+ * @param cap # paths there's room for
+ * @param path path to add
+ * @return exit status
  */
-int get_word_count(char *string, size_t len)
+int add_file(char ***files, int *files_n, int *cap, const char *path)
 {
-	int c = 1; // Account for 1st word w/ no preceding whitespace
-	for (int i = 0; i < len; i++) {
-		if (isspace(*(string+i)) != 0) {
-			c++;
+	if (*files_n == *cap) {
+		int new_cap = (*cap == 0) ? 16 : *cap * 2;
+		char **grown = realloc(*files, new_cap * sizeof(char*));
+		if (grown == NULL) {
+			return 4;
 		}
+		*files = grown;
+		*cap = new_cap;
+	}
+	if (((*files)[*files_n] = malloc(strlen(path)+1)) == NULL) {
+		return 4;
 	}
-	return c;
+	strcpy((*files)[*files_n], path);
+	(*files_n)++;
+	return 0;
 }
 
-/* Gets lowercase string for comparison to pre-defined null words
- * @param string word to convert to all lowercase
- * @param length of word
+/* Prints a single null word found by null finder
+ * @param data expect NULL
+ * @param word the null word
  */
-void get_lowercase(char *string, size_t len)
+void print_nulls(void *data, const char *word)
 {
-	if (string != NULL) {
-		for (int i = 0; i < len; i++) {
-			*(string+i) = tolower(*(string+i));
-		}
+	if (word != NULL) {
+		printf("%s, ", word);
 	}
 }
@@ -0,0 +1,115 @@
+/* Program to make up a synthetic CSV to train (& benchmark) find_null on
+ * Columns mix what real uncleaned data has: ids, numbers, dates, low & high cardinality words,
+ * quoted fields w/ delimiters & quotes inside, non-ASCII text, empty fields & null words in every case
+ * Same rows & seed always give the same file
+ *
+ * Exit status as in find_null.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local types */
+typedef unsigned long long rng_t;
+
+// Function declaration
+unsigned int next_rand(rng_t *rng);
+const char *pick(rng_t *rng, const char *const *words, int words_n);
+void write_row(rng_t *rng, long row);
+
+static const char *const NULLS[] = {"NaN", "-nan", "None", "NULL", "null", "N/A", "n/a", "#N/A", "NA", "<NA>", "nothing", "-1.#IND"};
+static const char *const CATEGORIES[] = {"Action", "Adventure", "Casual", "Indie", "RPG", "Simulation", "Sports", "Strategy"};
+static const char *const CITIES[] = {"São Paulo", "Zürich", "Москва", "Αθήνα", "Tōkyō", "NÃO INFORMADO", "Kraków", "Reykjavík"};
+static const char *const COMMENTS[] = {"great, would buy again", "said \"\"meh\"\"", "no comment", "Nothing to add", "ok"};
+#define PICK(rng, words) pick(rng, words, sizeof(words) / sizeof(words[0]))
+
+/* Writes header & rows to stdout
+ * @param argc # args passed
+ * @param argv args string array
+ * @return exit status
+ */
+int main(int argc, char *argv[])
+{
+	long rows;
+	rng_t rng;
+	char *rem;
+
+	if (argc != 2 && argc != 3) {
+		fprintf(stderr, "Usage: ./gen_csv rows_num [seed] > csv_file\n");
+		return 1;
+	}
+	rows = strtol(argv[1], &rem, 10);
+	if (*rem != '\0' || rows < 0) {
+		fprintf(stderr, "1st arg must be valid non-negative int\n");
+		return 1;
+	}
+	rng = (argc == 3) ? strtoull(argv[2], NULL, 10) : 2020;
+
+	printf("id,price,name,date,category,comment,code,city\n");
+	for (long i = 0; i < rows; i++) {
+		write_row(&rng, i);
+	}
+	if (fflush(stdout) != 0) {
+		return 4;
+	}
+
+	return 0;
+}
+
+/* Gives next pseudo-random #
+ * @param rng generator state, advanced
+ * @return pseudo-random # (31 bits)
+ */
+unsigned int next_rand(rng_t *rng)
+{
+	*rng = *rng * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (unsigned int)(*rng >> 33);
+}
+
+/* Picks a word at random
+ * @param rng generator state
+ * @param words words to pick from
+ * @param words_n # words
+ * @return word picked
+ */
+const char *pick(rng_t *rng, const char *const *words, int words_n)
+{
+	return words[next_rand(rng) % words_n];
+}
+
+/* Writes one row, a few percent of each col's fields being empty or null words
+ * @param rng generator state
+ * @param row row #, used as id
+ */
+void write_row(rng_t *rng, long row)
+{
+	unsigned int r = next_rand(rng);
+	unsigned int a = next_rand(rng); // Drawn up front, as args' order of evaluation isn't fixed
+	unsigned int b = next_rand(rng);
+	unsigned int c = next_rand(rng);
+
+	printf("%ld,", row + 1);
+	if (r % 50 == 0) {
+		printf("%s,", PICK(rng, NULLS));
+	}
+	else {
+		printf("%u.%02u,", a % 1000, b % 100);
+	}
+	if (r % 37 == 1) {
+		printf(",");
+	}
+	else {
+		printf("user%u,", a % 5000);
+	}
+	if (r % 29 == 2) {
+		printf("%s,", PICK(rng, NULLS));
+	}
+	else {
+		printf("20%02u-%02u-%02u,", a % 20, b % 12 + 1, c % 28 + 1);
+	}
+	printf("%s,", (r % 41 == 3) ? "" : PICK(rng, CATEGORIES));
+	printf("\"%s\",", (r % 23 == 4) ? PICK(rng, NULLS) : PICK(rng, COMMENTS));
+	printf("%08x,", next_rand(rng)); // High cardinality, grows tables
+	printf("%s\n", (r % 31 == 5) ? PICK(rng, NULLS) : PICK(rng, CITIES));
+}
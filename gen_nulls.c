@@ -0,0 +1,38 @@
+/* Program to compile a null words file into the program, rather than reading it at runtime
+ * Builds the matcher from the null file once & writes it out as C source (see matcher_write_tables),
+ * which the Makefile builds into find_null when STATIC_NULLS is given
+ *
+ * Exit status as in find_null.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "matcher.h"
+
+/* Reads null file & writes its matcher to stdout
+ * @param argc # args passed
+ * @param argv args string array
+ * @return exit status
+ */
+int main(int argc, char *argv[])
+{
+	matcher_t *nulls;
+	int stat;
+
+	if (argc != 3) {
+		fprintf(stderr, "Usage: ./gen_nulls null_file name > source_file\n");
+		return 1;
+	}
+	if ((nulls = matcher_load(argv[1])) == NULL) { // Same as find_null reads it at runtime
+		fprintf(stderr, "null_file must be readable file\n");
+		return 4;
+	}
+	printf("/* Generated by gen_nulls from %s; don't edit */\n\n", argv[1]);
+	stat = matcher_write_tables(nulls, argv[2], stdout);
+	matcher_free(nulls);
+	if (stat == 0 && fflush(stdout) != 0) {
+		stat = 4;
+	}
+
+	return stat;
+}
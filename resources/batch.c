@@ -0,0 +1,450 @@
+/* Batch mode's .c file
+ * See .h file for more details on each function
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "nullfinder.h"
+#include "chunker.h"
+#include "workpool.h"
+#include "batch.h"
+
+#define SPLIT_SIZE (64L * 1024 * 1024) // Files bigger than this get split into pieces
+#define PIECE_SIZE (4L * 1024 * 1024) // Smallest piece a single file read on its own is split into
+#define BUF_SIZE 65536
+
+/* Local types */
+
+// Everything about one file in the batch
+typedef struct batch_file {
+	char *path;
+	long *bounds; // Piece k is [bounds[k], bounds[k+1])
+	int pieces_n;
+	int cols_n; // From header, for pieces after 1st (0 if not split)
+	nullfinder_t **pieces; // One analyzer per piece, merged into 1st once all done
+	int remaining; // Pieces not done yet
+	int stat; // Exit status of worst piece
+	char *report; // Results once file's done
+	size_t report_len;
+	dialect_t dialect; // Given, or guessed from start of file
+	int bad_rows_n; // Rejects summed over pieces, once file's done
+	int parse_errors_n;
+	long skipped_n;
+} batch_file_t;
+
+// One piece of one file, a single task for the pool
+typedef struct piece {
+	int file;
+	int k; // Which piece of file
+} piece_t;
+
+// Shared by all tasks
+typedef struct batch {
+	batch_file_t *files;
+	piece_t *pieces;
+	matcher_t *nulls;
+	const dialect_t *dialect; // For every file, or starting point for guessing each file's
+	bad_rows_t bad_rows; // For every analyzer
+	FILE *quarantine;
+	bool prefetch; // For every analyzer
+	size_t memory_limit; // For every analyzer, its share of whole limit
+	nullfinder_t *into; // Reading a single file into caller's analyzer: 1st piece fed right into it, rest merged in; NULL in batch
+	pthread_mutex_t lock; // Guards remaining counts
+} batch_t;
+
+// Local function declaration
+static int plan_file(batch_file_t *file, matcher_t *nulls, const dialect_t *dialect, bool sniff, int threads_n, long split_size);
+static int feed_range(nullfinder_t *nf, FILE *fp, long start, long end);
+static void run_piece(void *data, int task);
+static void finish_file(batch_t *batch, batch_file_t *file);
+static int read_rest(batch_file_t *file, int k);
+static void write_null(void *data, const char *word);
+
+int batch_run(matcher_t *nulls, char **files, int files_n, int threads_n, const dialect_t *dialect, bool sniff, bad_rows_t bad_rows, FILE *quarantine, bool prefetch, size_t memory_limit, FILE *out)
+{
+	if (nulls == NULL || dialect == NULL || files == NULL || files_n < 0 || out == NULL || (bad_rows == BAD_ROWS_QUARANTINE && quarantine == NULL)) {
+		return 2;
+	}
+
+	batch_t batch;
+	int pieces_n = 0;
+	int stat = 0;
+
+	batch.nulls = nulls;
+	batch.dialect = dialect;
+	batch.bad_rows = bad_rows;
+	batch.quarantine = quarantine;
+	batch.prefetch = prefetch;
+	batch.memory_limit = memory_limit / threads_n; // At most threads_n analyzers being fed at once
+	batch.into = NULL;
+	if ((batch.files = calloc(files_n, sizeof(batch_file_t))) == NULL) {
+		return 4;
+	}
+
+	// Work out how each file gets split up first, so every piece is a task
+	for (int i = 0; i < files_n; i++) {
+		batch.files[i].path = files[i];
+		batch.files[i].stat = plan_file(&batch.files[i], nulls, dialect, sniff, threads_n, SPLIT_SIZE);
+		pieces_n += batch.files[i].pieces_n;
+	}
+	if ((batch.pieces = calloc(pieces_n > 0 ? pieces_n : 1, sizeof(piece_t))) == NULL) {
+		free(batch.files);
+		return 4;
+	}
+	pieces_n = 0;
+	for (int i = 0; i < files_n; i++) {
+		for (int k = 0; k < batch.files[i].pieces_n; k++) {
+			batch.pieces[pieces_n].file = i;
+			batch.pieces[pieces_n].k = k;
+			pieces_n++;
+		}
+	}
+
+	pthread_mutex_init(&batch.lock, NULL);
+	stat = workpool_run(pieces_n, threads_n, &batch, run_piece);
+	pthread_mutex_destroy(&batch.lock);
+
+	// Every file's report is ready, write them out in order
+	for (int i = 0; i < files_n; i++) {
+		batch_file_t *file = &batch.files[i];
+
+		fprintf(out, "FILE %s:\n", file->path);
+		if (file->stat != 0 || file->report == NULL) {
+			fprintf(out, "Error reading file (status %d).\n", file->stat != 0 ? file->stat : 4);
+			stat = (stat != 0) ? stat : (file->stat != 0 ? file->stat : 4);
+		}
+		else {
+			fwrite(file->report, sizeof(char), file->report_len, out);
+			if (file->bad_rows_n > 0 || file->parse_errors_n > 0) {
+				fprintf(stderr, "FILE %s: %d rows w/ wrong # fields (%s), %d parse errors (%ld bytes skipped)\n", file->path,
+					file->bad_rows_n, (bad_rows == BAD_ROWS_COUNT) ? "counted" : "left out", file->parse_errors_n, file->skipped_n);
+			}
+		}
+		fprintf(out, "\n");
+
+		free(file->report);
+		free(file->bounds);
+		free(file->pieces);
+	}
+	free(batch.pieces);
+	free(batch.files);
+	return stat;
+}
+
+int batch_read_file(nullfinder_t *nf, matcher_t *nulls, char *path, int threads_n, const dialect_t *dialect, bad_rows_t bad_rows, FILE *quarantine, bool prefetch, size_t memory_limit)
+{
+	if (nf == NULL || nulls == NULL || path == NULL || dialect == NULL || (bad_rows == BAD_ROWS_QUARANTINE && quarantine == NULL)) {
+		return 2;
+	}
+
+	batch_t batch;
+	batch_file_t file;
+	piece_t *pieces;
+	int stat;
+
+	memset(&file, 0, sizeof(batch_file_t));
+	file.path = path;
+	if ((stat = plan_file(&file, nulls, dialect, false, threads_n, PIECE_SIZE)) != 0) {
+		free(file.bounds);
+		free(file.pieces);
+		return stat;
+	}
+	if ((pieces = calloc(file.pieces_n, sizeof(piece_t))) == NULL) {
+		free(file.bounds);
+		free(file.pieces);
+		return 4;
+	}
+	for (int k = 0; k < file.pieces_n; k++) {
+		pieces[k].file = 0;
+		pieces[k].k = k;
+	}
+	batch.files = &file;
+	batch.pieces = pieces;
+	batch.nulls = nulls;
+	batch.dialect = dialect;
+	batch.bad_rows = bad_rows;
+	batch.quarantine = quarantine;
+	batch.prefetch = prefetch;
+	batch.memory_limit = memory_limit / threads_n;
+	batch.into = nf;
+	if ((stat = nullfinder_set_memory_limit(nf, batch.memory_limit)) != 0) {
+		free(pieces);
+		free(file.bounds);
+		free(file.pieces);
+		return stat;
+	}
+
+	pthread_mutex_init(&batch.lock, NULL);
+	stat = workpool_run(file.pieces_n, threads_n, &batch, run_piece);
+	pthread_mutex_destroy(&batch.lock);
+	nullfinder_set_memory_limit(nf, memory_limit); // Only nf left, so it gets all of it
+
+	free(pieces);
+	free(file.bounds);
+	free(file.pieces);
+	return (stat != 0) ? stat : file.stat;
+}
+
+/* Decide how file's written, how many pieces it gets & where they start & end
+ * Small files are 1 piece; big ones are split into at most threads_n pieces on row boundaries
+ * @param file file to plan, path filled in already
+ * @param nulls null words matcher
+ * @param dialect how file's written, or starting point for guess
+ * @param sniff whether to guess delimiter, quote & encoding from start of file
+ * @param threads_n # threads in pool
+ * @param split_size bytes per piece before file's split any further
+ * @return exit status, file is 0 pieces if not 0
+ */
+static int plan_file(batch_file_t *file, matcher_t *nulls, const dialect_t *dialect, bool sniff, int threads_n, long split_size)
+{
+	struct stat st;
+	FILE *fp;
+	int pieces_n;
+	long header_end;
+
+	file->pieces_n = 0;
+	if (stat(file->path, &st) != 0 || (fp = fopen(file->path, "r")) == NULL) {
+		return 1;
+	}
+	file->dialect = *dialect;
+	if (sniff) {
+		char sample[SNIFF_SIZE];
+		size_t sample_len = fread(sample, sizeof(char), SNIFF_SIZE, fp);
+		dialect_sniff(sample, sample_len, &file->dialect);
+	}
+	pieces_n = (int)(st.st_size / split_size) + 1;
+	if (pieces_n > threads_n) {
+		pieces_n = threads_n;
+	}
+	if (pieces_n < 1) {
+		pieces_n = 1;
+	}
+
+	file->bounds = calloc(pieces_n + 1, sizeof(long));
+	file->pieces = calloc(pieces_n, sizeof(nullfinder_t*));
+	if (file->bounds == NULL || file->pieces == NULL) {
+		fclose(fp);
+		return 4;
+	}
+	file->bounds[0] = 0;
+	file->bounds[pieces_n] = (long)st.st_size;
+
+	if (pieces_n > 1) {
+		if (chunker_split(fp, (long)st.st_size, pieces_n, file->dialect.quote, threads_n, file->bounds, &header_end) != 0) {
+			fclose(fp);
+			return 4;
+		}
+
+		// Later pieces don't get the header, so count its columns now by running it through an analyzer of its own
+		nullfinder_t *header = nullfinder_new_shared(nulls, 0);
+		bool whole = false; // Header end chunker found is really where 1st row ends
+		int stat = (header != NULL) ? nullfinder_set_dialect(header, &file->dialect) : 4;
+		if (stat == 0) {
+			stat = feed_range(header, fp, 0, header_end);
+		}
+		if (stat == 0) {
+			whole = !nullfinder_mid_row(header) && nullfinder_get_rows_read(header) == 0;
+		}
+		if (stat == 0 && whole && nullfinder_finalize(header) == 0) {
+			file->cols_n = nullfinder_get_cols_n(header);
+		}
+		nullfinder_free(header);
+		if (stat != 0) {
+			fclose(fp);
+			return stat;
+		}
+		if (!whole || file->cols_n <= 0) { // Chunker's off from the start (stray quote in header), so just read it in one go
+			pieces_n = 1;
+			file->bounds[1] = (long)st.st_size;
+		}
+	}
+	fclose(fp);
+
+	file->remaining = pieces_n;
+	file->pieces_n = pieces_n;
+	return 0;
+}
+
+/* Feeds part of a file into an analyzer
+ * @param nf analyzer to feed
+ * @param fp file to read from
+ * @param start offset to start at
+ * @param end offset to stop just before
+ * @return exit status
+ */
+static int feed_range(nullfinder_t *nf, FILE *fp, long start, long end)
+{
+	char buf[BUF_SIZE];
+	long left = end - start;
+	size_t bytes_read;
+
+	if (fseek(fp, start, SEEK_SET) != 0) {
+		return 4;
+	}
+	while (left > 0 && (bytes_read = fread(buf, sizeof(char), left < BUF_SIZE ? (size_t)left : BUF_SIZE, fp)) > 0) {
+		int stat = nullfinder_feed(nf, buf, bytes_read);
+		if (stat != 0) {
+			return stat;
+		}
+		left -= (long)bytes_read;
+	}
+	return (left > 0) ? 4 : 0; // Shouldn't come up short unless file changed under us
+}
+
+/* Analyzes a single piece of a file; last piece of a file to finish also finishes off file
+ * Run by workpool_run, at same time as other pieces
+ * @param data batch_t ptr
+ * @param task index into batch's pieces
+ */
+static void run_piece(void *data, int task)
+{
+	batch_t *batch = (batch_t *)data;
+	piece_t *piece = &batch->pieces[task];
+	batch_file_t *file = &batch->files[piece->file];
+	nullfinder_t *nf;
+	FILE *fp = NULL;
+	int stat = 0;
+	bool last;
+
+	if (batch->into != NULL && piece->k == 0) { // Caller's analyzer, set up already
+		nf = batch->into;
+	}
+	else if ((nf = nullfinder_new_shared(batch->nulls, 0)) == NULL) {
+		stat = 4;
+	}
+	else if ((stat = nullfinder_set_dialect(nf, &file->dialect)) == 0) {
+		stat = nullfinder_set_bad_rows(nf, batch->bad_rows, batch->quarantine);
+	}
+	if (stat == 0 && nf != batch->into) {
+		stat = nullfinder_set_prefetch(nf, batch->prefetch);
+	}
+	if (stat == 0 && nf != batch->into) {
+		stat = nullfinder_set_memory_limit(nf, batch->memory_limit);
+	}
+	if (stat == 0 && piece->k > 0) { // No header in this piece
+		stat = nullfinder_set_cols_n(nf, file->cols_n);
+	}
+	if (stat == 0) {
+		if ((fp = fopen(file->path, "r")) == NULL) {
+			stat = 4;
+		}
+		else {
+			stat = feed_range(nf, fp, file->bounds[piece->k], file->bounds[piece->k + 1]);
+			fclose(fp);
+		}
+	}
+
+	// Waiting to be merged, so let thread's share of memory go to next piece
+	if (stat == 0 && batch->memory_limit > 0 && file->pieces_n > 1) {
+		stat = nullfinder_spill(nf);
+	}
+
+	pthread_mutex_lock(&batch->lock);
+	file->pieces[piece->k] = nf;
+	if (stat != 0) {
+		file->stat = stat;
+	}
+	last = (--file->remaining == 0);
+	pthread_mutex_unlock(&batch->lock);
+
+	if (last) {
+		finish_file(batch, file);
+	}
+}
+
+/* Once every piece of a file is done, merges pieces in order, finalizes & writes up results (unless reading into caller's analyzer)
+ * @param batch batch file is in
+ * @param file file to finish
+ */
+static void finish_file(batch_t *batch, batch_file_t *file)
+{
+	nullfinder_t *nf = file->pieces[0];
+	FILE *report;
+
+	// Chunker only guesses which newlines are inside quoted fields (a stray quote in an unquoted field, which
+	// lenient parsing takes as is, throws it off); if a piece didn't end at a row's end, pieces after it started
+	// partway into one, so drop them & read on from where it stopped instead
+	for (int k = 0; k < file->pieces_n - 1 && file->stat == 0; k++) {
+		if (nullfinder_mid_row(file->pieces[k])) {
+			file->stat = read_rest(file, k);
+		}
+	}
+	for (int k = 1; k < file->pieces_n && file->stat == 0; k++) {
+		file->stat = nullfinder_merge(nf, file->pieces[k]);
+	}
+	if (batch->into != NULL) { // Caller finishes off its own analyzer
+		for (int k = 1; k < file->pieces_n; k++) {
+			nullfinder_free(file->pieces[k]);
+			file->pieces[k] = NULL;
+		}
+		return;
+	}
+	if (file->stat == 0) {
+		nullfinder_set_threads(nf, 1); // Pool's already busy w/ other files
+		file->stat = nullfinder_finalize(nf);
+		file->bad_rows_n = nullfinder_get_bad_rows(nf);
+		file->parse_errors_n = nullfinder_get_parse_errors(nf);
+		file->skipped_n = nullfinder_get_skipped(nf);
+	}
+
+	if (file->stat == 0) {
+		if ((report = open_memstream(&file->report, &file->report_len)) == NULL) {
+			file->stat = 4;
+		}
+		else {
+			for (int i = 0; i < nullfinder_get_cols_n(nf); i++) {
+				fprintf(report, "COLUMN %d: \n", i+1);
+				nullfinder_iterate(nf, i, report, write_null);
+				fprintf(report, "\n");
+			}
+			fclose(report);
+		}
+	}
+
+	for (int k = 0; k < file->pieces_n; k++) {
+		nullfinder_free(file->pieces[k]);
+		file->pieces[k] = NULL;
+	}
+}
+
+/* Feeds rest of file into a piece that stopped partway into a row, dropping pieces after it
+ * @param file file piece is in
+ * @param k which piece, becomes file's last
+ * @return exit status
+ */
+static int read_rest(batch_file_t *file, int k)
+{
+	FILE *fp;
+	int stat;
+
+	if ((fp = fopen(file->path, "r")) == NULL) {
+		return 4;
+	}
+	stat = feed_range(file->pieces[k], fp, file->bounds[k+1], file->bounds[file->pieces_n]);
+	fclose(fp);
+
+	for (int i = k + 1; i < file->pieces_n; i++) {
+		nullfinder_free(file->pieces[i]);
+		file->pieces[i] = NULL;
+	}
+	file->bounds[k+1] = file->bounds[file->pieces_n];
+	file->pieces_n = k + 1;
+	return stat;
+}
+
+/* Writes a single null word found into a file's report
+ * @param data FILE ptr of report
+ * @param word the null word
+ */
+static void write_null(void *data, const char *word)
+{
+	if (data != NULL && word != NULL) {
+		fprintf((FILE *)data, "%s, ", word);
+	}
+}
@@ -0,0 +1,48 @@
+/* Batch mode: find null words in many csv files in one go
+ * Null words matcher is built once & shared, files (and pieces of big files) are spread across a thread pool,
+ * and results come out as one report w/ files in the order given
+ */
+
+#ifndef __BATCH_H
+#define __BATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "matcher.h"
+#include "nullfinder.h"
+
+/* Analyze every file & write combined report
+ * @param nulls matcher built from null words, shared by all files
+ * @param files array of csv file paths
+ * @param files_n # files
+ * @param threads_n # threads to use
+ * @param dialect how every file's written, or starting point if guessing
+ * @param sniff whether to guess each file's delimiter, quote & encoding from its first few KB
+ * @param bad_rows what to do w/ rows that don't have as many fields as header (summary of them per file goes to stderr)
+ * @param quarantine where rows left out go if quarantining, shared by all files
+ * @param prefetch whether analyzers prefetch column slots (see nullfinder_set_prefetch)
+ * @param memory_limit bytes column tables of every analyzer running at once can take up in all, before spilling to disk
+ *	(see nullfinder_set_memory_limit), 0 for no limit
+ * @param out where to write report
+ * @return exit status (0 only if every file was analyzed)
+ */
+int batch_run(matcher_t *nulls, char **files, int files_n, int threads_n, const dialect_t *dialect, bool sniff, bad_rows_t bad_rows, FILE *quarantine, bool prefetch, size_t memory_limit, FILE *out);
+
+/* Read a single file into an analyzer, parsing pieces of it in parallel so one big file can use every core:
+ * file's split on row boundaries (see chunker.h), 1st piece (w/ header) is fed right into nf & every other piece
+ * into an analyzer of its own, merged into nf once done
+ * @param nf analyzer to read into, dialect & bad rows already set, nothing fed yet; left unfinalized
+ * @param nulls matcher nf was built from, shared by pieces
+ * @param path csv file, must be a regular file (pieces are read at offsets)
+ * @param threads_n # threads to use, also most pieces file's split into
+ * @param dialect how file's written, same as nf's
+ * @param bad_rows same as nf's
+ * @param quarantine same as nf's
+ * @param prefetch same as nf's
+ * @param memory_limit bytes column tables of nf & every piece can take up in all, 0 for no limit; nf's set to it once done
+ * @return exit status
+ */
+int batch_read_file(nullfinder_t *nf, matcher_t *nulls, char *path, int threads_n, const dialect_t *dialect, bad_rows_t bad_rows, FILE *quarantine, bool prefetch, size_t memory_limit);
+
+#endif
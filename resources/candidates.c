@@ -0,0 +1,99 @@
+/* Candidates index's .c file
+ * See .h file for more details on each function
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "candidates.h"
+
+/* Local types */
+
+// A single short value; key kept inline, no separate allocation
+typedef struct candidate {
+	char key[CANDIDATE_LEN];
+	float *count;
+} candidate_t;
+
+/* Global type */
+typedef struct candidates {
+	candidate_t *items; // Grows by doubling
+	int items_n;
+	int cap;
+} candidates_t;
+
+candidates_t *candidates_new(void)
+{
+	candidates_t *new = malloc(sizeof(candidates_t));
+	if (new == NULL) {
+		return NULL;
+	}
+
+	new->items = NULL;
+	new->items_n = 0;
+	new->cap = 0;
+
+	return new;
+}
+
+int candidates_add(candidates_t *cands, const char *key, float *count)
+{
+	if (cands == NULL || key == NULL || count == NULL) {
+		return 2;
+	}
+	size_t len = strlen(key);
+	if (len >= CANDIDATE_LEN) {
+		return 2;
+	}
+
+	if (cands->items_n == cands->cap) {
+		int cap = (cands->cap == 0) ? 16 : cands->cap * 2;
+		candidate_t *items = realloc(cands->items, cap * sizeof(candidate_t));
+		if (items == NULL) {
+			return 4;
+		}
+		cands->items = items;
+		cands->cap = cap;
+	}
+
+	memcpy(cands->items[cands->items_n].key, key, len+1);
+	cands->items[cands->items_n].count = count;
+	cands->items_n++;
+	return 0;
+}
+
+int candidates_get_n(candidates_t *cands)
+{
+	if (cands != NULL) {return cands->items_n;}
+	return -1;
+}
+
+size_t candidates_get_size(candidates_t *cands)
+{
+	if (cands != NULL) {return sizeof(candidates_t) + cands->cap * sizeof(candidate_t);}
+	return 0;
+}
+
+void candidates_iterate(candidates_t *cands, void *data, void (*func)(void *data, const char *key, void *val))
+{
+	if (cands != NULL && func != NULL) {
+		for (int i = 0; i < cands->items_n; i++) {
+			(*func)(data, cands->items[i].key, cands->items[i].count);
+		}
+	}
+}
+
+void candidates_clear(candidates_t *cands)
+{
+	if (cands != NULL) {
+		cands->items_n = 0;
+	}
+}
+
+void candidates_free(candidates_t *cands)
+{
+	if (cands != NULL) {
+		free(cands->items);
+		free(cands);
+	}
+}
@@ -0,0 +1,60 @@
+/* Candidates: index of the values in a column that are short enough to ever be reported as null words
+ * by rarity (under CANDIDATE_LEN chars, at most 3 words). Filled in as new values show up, so
+ * finalizing only has to look at these instead of every unique value in column
+ */
+
+#ifndef __CANDIDATES_H
+#define __CANDIDATES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CANDIDATE_LEN 10 // Values this long or longer are never null words by rarity
+
+/* Type definition */
+typedef struct candidates candidates_t;
+
+/* Initialize a new empty index
+ * @return ptr to new index or NULL if error
+ */
+candidates_t *candidates_new(void);
+
+/* Add a value to index
+ * @param cands index to add to
+ * @param key value, shorter than CANDIDATE_LEN (copied)
+ * @param count ptr to value's freq, owned by column table & must stay put while in index
+ * @return exit status
+ */
+int candidates_add(candidates_t *cands, const char *key, float *count);
+
+/* Get # values in index
+ * @param cands index of interest
+ * @return # values or -1 if error
+ */
+int candidates_get_n(candidates_t *cands);
+
+/* Get # bytes index takes up
+ * @param cands index of interest
+ * @return # bytes, 0 if error
+ */
+size_t candidates_get_size(candidates_t *cands);
+
+/* Iterate through index, applying func to every value
+ * Same func as hashtable_iterate takes, so the same callbacks work for both
+ * @param cands index to iterate through
+ * @param data whatever user wants to pass to func
+ * @param func function applied to every value; val is float ptr to freq
+ */
+void candidates_iterate(candidates_t *cands, void *data, void (*func)(void *data, const char *key, void *val));
+
+/* Empty out index, e.g. when column table it points into is replaced
+ * @param cands index to empty
+ */
+void candidates_clear(candidates_t *cands);
+
+/* Frees up index (not the freqs it points to)
+ * @param cands index to free
+ */
+void candidates_free(candidates_t *cands);
+
+#endif
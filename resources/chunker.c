@@ -0,0 +1,141 @@
+/* Csv file splitter's .c file
+ * See .h file for more details on each function
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "workpool.h"
+#include "chunker.h"
+
+#define BUF_SIZE 65536
+
+/* Local types */
+
+// What one scan of a segment found, under both guesses of whether segment starts inside quotes
+typedef struct segment {
+	long start;
+	long end;
+	bool odd; // Odd # quote chars in segment, i.e. quote state at end is flipped from start
+	long row_end[2]; // Offset just past 1st newline that ends a row if segment starts outside [0] / inside [1] quotes, -1 if none
+	int stat;
+} segment_t;
+
+// Shared by every scan
+typedef struct scan {
+	int fd;
+	char quote;
+	segment_t *segments;
+} scan_t;
+
+// Local function declaration
+static void scan_segment(void *data, int task);
+
+int chunker_split(FILE *fp, long size, int chunks_n, char quote, int threads_n, long *bounds, long *header_end)
+{
+	if (fp == NULL || chunks_n < 1 || bounds == NULL || header_end == NULL || size < 0) {
+		return 2;
+	}
+
+	scan_t scan;
+	bool quoted = false; // Real quote state at start of each segment, known once segments before it are scanned
+	long found = -1; // Real 1st row end found in a segment, scanning back from last segment
+	int stat = 0;
+
+	// Segment k starts just before bound k's target, so 1st row end found from there on is where to cut
+	if ((scan.segments = calloc(chunks_n, sizeof(segment_t))) == NULL) {
+		return 4;
+	}
+	scan.fd = fileno(fp);
+	scan.quote = quote;
+	for (int k = 0; k < chunks_n; k++) {
+		long start = (k == 0) ? 0 : size / chunks_n * k - 1;
+		scan.segments[k].start = (k > 0 && start < scan.segments[k-1].start) ? scan.segments[k-1].start : start;
+		if (scan.segments[k].start < 0) {
+			scan.segments[k].start = 0;
+		}
+		if (k > 0) {
+			scan.segments[k-1].end = scan.segments[k].start;
+		}
+	}
+	scan.segments[chunks_n-1].end = size;
+
+	// Every segment's scanned at once; not knowing quote state up front is fine since both guesses are tracked
+	if ((stat = workpool_run(chunks_n, threads_n, &scan, scan_segment)) != 0) {
+		free(scan.segments);
+		return stat;
+	}
+
+	// Now states are known in order, so pick row end under the right guess
+	for (int k = 0; k < chunks_n; k++) {
+		segment_t *segment = &scan.segments[k];
+		if (segment->stat != 0) {
+			stat = segment->stat;
+		}
+		long row_end = segment->row_end[quoted ? 1 : 0];
+		quoted = (quoted != segment->odd);
+		segment->row_end[0] = row_end; // Real one, from here on
+	}
+	if (stat != 0) {
+		free(scan.segments);
+		return stat;
+	}
+
+	// Pieces we couldn't find a cut for are empty, whatever's left over goes in last piece
+	bounds[0] = 0;
+	bounds[chunks_n] = size;
+	for (int k = chunks_n - 1; k >= 0; k--) {
+		if (scan.segments[k].row_end[0] >= 0) {
+			found = scan.segments[k].row_end[0];
+		}
+		if (k > 0) {
+			bounds[k] = (found >= 0) ? found : size;
+		}
+	}
+	*header_end = (found >= 0) ? found : size;
+	free(scan.segments);
+	return 0;
+}
+
+/* Scans a segment for quote parity & 1st row end under both guesses of starting quote state
+ * Run by workpool_run, at same time as other segments
+ * @param data scan_t ptr
+ * @param task index of segment
+ */
+static void scan_segment(void *data, int task)
+{
+	scan_t *scan = (scan_t *)data;
+	segment_t *segment = &scan->segments[task];
+	char *buf = malloc(BUF_SIZE);
+	long pos = segment->start; // Offset of buf[0]
+	bool odd = false; // Quotes so far; doubled quotes inside a quoted field toggle twice so come out even
+
+	segment->row_end[0] = -1;
+	segment->row_end[1] = -1;
+	if (buf == NULL) {
+		segment->stat = 4;
+		return;
+	}
+	while (pos < segment->end) {
+		long want = segment->end - pos;
+		ssize_t bytes_read = pread(scan->fd, buf, want < BUF_SIZE ? (size_t)want : BUF_SIZE, (off_t)pos);
+		if (bytes_read <= 0) { // Shouldn't come up short unless file changed under us
+			segment->stat = 4;
+			break;
+		}
+		for (ssize_t i = 0; i < bytes_read; i++) {
+			if (buf[i] == scan->quote) {
+				odd = !odd;
+			}
+			else if (buf[i] == '\n' && segment->row_end[odd] < 0) { // Outside quotes if segment started w/ same state as now
+				segment->row_end[odd] = pos + (long)i + 1;
+			}
+		}
+		pos += (long)bytes_read;
+	}
+	segment->odd = odd;
+	free(buf);
+}
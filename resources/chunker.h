@@ -0,0 +1,27 @@
+/* Splits a csv file into pieces that start & end on row boundaries, so each piece can be parsed on its own
+ * A newline only ends a row if it isn't inside a quoted field, so we keep track of quotes as we go
+ * File is scanned in segments in parallel; a segment can't know if it starts inside quotes until the ones before it
+ * are done, so each scan tracks both guesses & the right one is picked after
+ * Quote parity is only a guess at how the parser will read the file: a stray quote in an unquoted field (e.g. 12")
+ * flips it, so callers should check each piece really ends on a row boundary (see nullfinder_mid_row)
+ */
+
+#ifndef __CHUNKER_H
+#define __CHUNKER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Find row boundaries to split file at, as close to evenly sized pieces as possible
+ * @param fp file to split, read w/o moving its position
+ * @param size # bytes in file
+ * @param chunks_n # pieces wanted
+ * @param quote quote char used in file
+ * @param threads_n # threads to scan w/
+ * @param bounds array of chunks_n+1 offsets to fill in; piece k is [bounds[k], bounds[k+1]), some may be empty
+ * @param header_end filled in w/ offset just past end of 1st row (size if only 1 row)
+ * @return exit status
+ */
+int chunker_split(FILE *fp, long size, int chunks_n, char quote, int threads_n, long *bounds, long *header_end);
+
+#endif
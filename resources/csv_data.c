@@ -5,27 +5,36 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "csv_data.h"
 #include "hashtable.h"
 
 typedef struct csv_data {
-	int rows_n; // Num of rows in file
+	int rows_n; // Num of rows in file (as supplied by user, <= 0 if unknown)
+	int rows_read; // Num of data rows actually read so far
+	double rows_weight; // Same as rows_read unless freqs scaled down, then scaled down the same
+	float min_count; // Lowest freq a word still counted can have
 	int cols_n; // Num of cols in file
-	int col_curr; // Current column # we're processing (can be for anything: reading fields, iterating through hashtable items, etc.)
+	int col_curr; // Current column # we're processing while reading fields (finishing off cols doesn't use it, so cols can be done in parallel)
 	hashtable_t **columns; // Each hashtable in array reps a column, in each column table key is field/word, val is freq at
 				//which word appears in col (at the end change to probability occur in col)
+	typed_column_t **typed; // Each item reps a column; if col turns out numeric/date, its values that fit are counted here instead of in columns
+	candidates_t **candidates; // Each item reps a column, indexes short values in columns table that could be null words by rarity
 	hashtable_t **column_to_nulls; // Each hashtable in array reps a column, in each column table word is key, val is dummy item
-	char **nulls; // Array of strings that are pre-defined null-equivalent words (found in resources/nulls)
+	hashtable_t **column_to_rare; // Same as column_to_nulls, but only words found by rarity; redone every time results worked out
+	results_t **column_to_results; // Each item reps a column, every null word found (both kinds) w/ freq, sorted; redone w/ column_to_rare
+	spill_runs_t **column_to_runs; // Each item reps a column, its freqs written out to disk so far (NULL if col never spilled)
+	matcher_t *nulls; // Matcher for pre-defined null-equivalent words (found in resources/nulls), may be shared w/ other structs
 	float **avg_probabilities; // Array of floats, each float is avg probability at which words appear that respective col
 				//(0th item is 1st col, so on)
 } csv_data_t;
 
-// Local function
-static void count_unique_rows(void *arg, const char *key, void *val);
+// Local function declaration
+static void *grow_array(void *arr, int old_n, int n);
 
-csv_data_t *csv_data_new(char **nulls, int rows)
+csv_data_t *csv_data_new(matcher_t *nulls, int rows)
 {
-	if (nulls == NULL) { // Array must be prepopulated!!!
+	if (nulls == NULL) { // Matcher must be built already!!!
 		return NULL;
 	}
 
@@ -35,22 +44,134 @@ csv_data_t *csv_data_new(char **nulls, int rows)
 	}
 	
 	new->rows_n = rows;
+	new->rows_read = 0;
+	new->rows_weight = 0;
+	new->min_count = 1;
 	new->cols_n = 0;
 	new->col_curr = 0;
 	new->columns = NULL;
+	new->typed = NULL;
+	new->candidates = NULL;
 	new->column_to_nulls = NULL;
+	new->column_to_rare = NULL;
+	new->column_to_results = NULL;
+	new->column_to_runs = NULL;
 	new->nulls = nulls;
 	new->avg_probabilities = NULL;
 
 	return new;
 }
 
+void csv_data_free(csv_data_t *csv)
+{
+	if (csv != NULL) {
+		for (int i = 0; i < csv->cols_n; i++) {
+			if (csv->columns != NULL) {
+				hashtable_free(csv->columns[i]);
+			}
+			if (csv->typed != NULL) {
+				typed_column_free(csv->typed[i]);
+			}
+			if (csv->candidates != NULL) {
+				candidates_free(csv->candidates[i]);
+			}
+			if (csv->column_to_nulls != NULL) {
+				hashtable_free(csv->column_to_nulls[i]);
+			}
+			if (csv->column_to_rare != NULL) {
+				hashtable_free(csv->column_to_rare[i]);
+			}
+			if (csv->column_to_results != NULL) {
+				results_free(csv->column_to_results[i]);
+			}
+			if (csv->column_to_runs != NULL) {
+				spill_runs_free(csv->column_to_runs[i]);
+			}
+			if (csv->avg_probabilities != NULL) {
+				free(csv->avg_probabilities[i]); // NULL if col never finished, fine to free
+			}
+		}
+		free(csv->columns);
+		free(csv->typed);
+		free(csv->candidates);
+		free(csv->column_to_nulls);
+		free(csv->column_to_rare);
+		free(csv->column_to_results);
+		free(csv->column_to_runs);
+		free(csv->avg_probabilities);
+		free(csv);
+	}
+}
+
 int csv_data_get_rows_n(csv_data_t *csv)
 {
 	if (csv != NULL) {return csv->rows_n;}
 	return -1;
 }
 
+int csv_data_set_rows_n(csv_data_t *csv, int n)
+{
+	if (csv != NULL) {
+		csv->rows_n = n;
+		return csv->rows_n;
+	}
+	return -1;
+}
+
+int csv_data_get_rows_read(csv_data_t *csv)
+{
+	if (csv != NULL) {return csv->rows_read;}
+	return -1;
+}
+
+int csv_data_set_rows_read(csv_data_t *csv, int n)
+{
+	if (csv != NULL) {
+		csv->rows_read = n;
+		return csv->rows_read;
+	}
+	return -1;
+}
+
+int csv_data_inc_rows_read(csv_data_t *csv)
+{
+	if (csv != NULL) {
+		csv->rows_weight++;
+		return ++csv->rows_read;
+	}
+	return -1;
+}
+
+double csv_data_get_rows_weight(csv_data_t *csv)
+{
+	if (csv != NULL) {return csv->rows_weight;}
+	return -1;
+}
+
+double csv_data_set_rows_weight(csv_data_t *csv, double w)
+{
+	if (csv != NULL) {
+		csv->rows_weight = w;
+		return csv->rows_weight;
+	}
+	return -1;
+}
+
+float csv_data_get_min_count(csv_data_t *csv)
+{
+	if (csv != NULL) {return csv->min_count;}
+	return -1;
+}
+
+float csv_data_set_min_count(csv_data_t *csv, float c)
+{
+	if (csv != NULL) {
+		csv->min_count = c;
+		return csv->min_count;
+	}
+	return -1;
+}
+
 int csv_data_get_cols_n(csv_data_t *csv)
 {
 	if (csv != NULL) {return csv->cols_n;}
@@ -66,6 +187,74 @@ int csv_data_set_cols_n(csv_data_t *csv, int n)
 	return -1;
 }
 
+int csv_data_grow_cols_n(csv_data_t *csv, int n)
+{
+	void *grown;
+
+	if (csv == NULL || n < csv->cols_n) {
+		return -1;
+	}
+	// Arrays that did grow keep their new size if a later one can't, extra items just go unused
+	if ((grown = grow_array(csv->columns, csv->cols_n, n)) == NULL) {
+		return -1;
+	}
+	csv->columns = grown;
+	if ((grown = grow_array(csv->typed, csv->cols_n, n)) == NULL) {
+		return -1;
+	}
+	csv->typed = grown;
+	if ((grown = grow_array(csv->candidates, csv->cols_n, n)) == NULL) {
+		return -1;
+	}
+	csv->candidates = grown;
+	if ((grown = grow_array(csv->column_to_nulls, csv->cols_n, n)) == NULL) {
+		return -1;
+	}
+	csv->column_to_nulls = grown;
+	// Only made once results worked out, so only grow if already there
+	if (csv->column_to_rare != NULL) {
+		if ((grown = grow_array(csv->column_to_rare, csv->cols_n, n)) == NULL) {
+			return -1;
+		}
+		csv->column_to_rare = grown;
+	}
+	if (csv->column_to_results != NULL) {
+		if ((grown = grow_array(csv->column_to_results, csv->cols_n, n)) == NULL) {
+			return -1;
+		}
+		csv->column_to_results = grown;
+	}
+	if (csv->column_to_runs != NULL) {
+		if ((grown = grow_array(csv->column_to_runs, csv->cols_n, n)) == NULL) {
+			return -1;
+		}
+		csv->column_to_runs = grown;
+	}
+	if (csv->avg_probabilities != NULL) {
+		if ((grown = grow_array(csv->avg_probabilities, csv->cols_n, n)) == NULL) {
+			return -1;
+		}
+		csv->avg_probabilities = grown;
+	}
+	csv->cols_n = n;
+	return csv->cols_n;
+}
+
+/* Resizes per-col array of ptrs, new items set to NULL
+ * @param arr array to resize (NULL if not made yet)
+ * @param old_n # items in array
+ * @param n # items wanted
+ * @return resized array, or NULL if malloc error (arr still valid then)
+ */
+static void *grow_array(void *arr, int old_n, int n)
+{
+	char *grown = realloc(arr, (n > 0 ? n : 1) * sizeof(void*));
+	if (grown != NULL && n > old_n) {
+		memset(grown + old_n * sizeof(void*), 0, (n - old_n) * sizeof(void*));
+	}
+	return grown;
+}
+
 int csv_data_get_col_curr(csv_data_t *csv)
 {
 	if (csv != NULL) {return csv->col_curr;}
@@ -99,6 +288,42 @@ hashtable_t **csv_data_new_columns(csv_data_t *csv)
 	return NULL;
 }
 
+typed_column_t **csv_data_get_typed(csv_data_t *csv)
+{
+	if (csv != NULL) {return csv->typed;}
+	return NULL;
+}
+
+typed_column_t **csv_data_new_typed(csv_data_t *csv)
+{
+	if (csv != NULL) {
+		csv->typed = calloc(csv->cols_n, sizeof(typed_column_t*));
+		if (csv->typed == NULL) {
+			return NULL;
+		}
+		return csv->typed;
+	}
+	return NULL;
+}
+
+candidates_t **csv_data_get_candidates(csv_data_t *csv)
+{
+	if (csv != NULL) {return csv->candidates;}
+	return NULL;
+}
+
+candidates_t **csv_data_new_candidates(csv_data_t *csv)
+{
+	if (csv != NULL) {
+		csv->candidates = calloc(csv->cols_n, sizeof(candidates_t*));
+		if (csv->candidates == NULL) {
+			return NULL;
+		}
+		return csv->candidates;
+	}
+	return NULL;
+}
+
 hashtable_t **csv_data_get_column_to_nulls(csv_data_t *csv)
 {
 	if (csv != NULL) {return csv->column_to_nulls;}
@@ -117,7 +342,61 @@ hashtable_t **csv_data_new_column_to_nulls(csv_data_t *csv)
 	return NULL;
 }
 
-char **csv_data_get_nulls(csv_data_t *csv)
+hashtable_t **csv_data_get_column_to_rare(csv_data_t *csv)
+{
+	if (csv != NULL) {return csv->column_to_rare;}
+	return NULL;
+}
+
+hashtable_t **csv_data_new_column_to_rare(csv_data_t *csv)
+{
+	if (csv != NULL) {
+		csv->column_to_rare = calloc(csv->cols_n, sizeof(hashtable_t*));
+		if (csv->column_to_rare == NULL) {
+			return NULL;
+		}
+		return csv->column_to_rare;
+	}
+	return NULL;
+}
+
+results_t **csv_data_get_column_to_results(csv_data_t *csv)
+{
+	if (csv != NULL) {return csv->column_to_results;}
+	return NULL;
+}
+
+results_t **csv_data_new_column_to_results(csv_data_t *csv)
+{
+	if (csv != NULL) {
+		csv->column_to_results = calloc(csv->cols_n, sizeof(results_t*));
+		if (csv->column_to_results == NULL) {
+			return NULL;
+		}
+		return csv->column_to_results;
+	}
+	return NULL;
+}
+
+spill_runs_t **csv_data_get_column_to_runs(csv_data_t *csv)
+{
+	if (csv != NULL) {return csv->column_to_runs;}
+	return NULL;
+}
+
+spill_runs_t **csv_data_new_column_to_runs(csv_data_t *csv)
+{
+	if (csv != NULL) {
+		csv->column_to_runs = calloc(csv->cols_n, sizeof(spill_runs_t*));
+		if (csv->column_to_runs == NULL) {
+			return NULL;
+		}
+		return csv->column_to_runs;
+	}
+	return NULL;
+}
+
+matcher_t *csv_data_get_nulls(csv_data_t *csv)
 {
 	if (csv != NULL) {return csv->nulls;}
 	return NULL;
@@ -126,19 +405,14 @@ char **csv_data_get_nulls(csv_data_t *csv)
 float **csv_data_avg_probabilities_new(csv_data_t *csv)
 {	
 	if (csv != NULL) {
+		if (csv->avg_probabilities != NULL) { // Already made, just reuse
+			return csv->avg_probabilities;
+		}
 		csv->avg_probabilities = calloc(csv->cols_n, sizeof(float*));
 		if (csv->avg_probabilities == NULL) {
 			return NULL;
 		}
 
-		for (int i = 0; i < csv->cols_n; i++) {
-			float *avg = malloc(sizeof(float));
-			int sum = 0;
-			hashtable_iterate(*(csv->columns+i), &sum, count_unique_rows);
-			*(avg) = (float)1 / (float)sum;
-			csv->avg_probabilities[i] = avg;
-		}
-
 		return csv->avg_probabilities;
 	}
 	else {
@@ -146,16 +420,23 @@ float **csv_data_avg_probabilities_new(csv_data_t *csv)
 	}
 }
 
-/* To count number of items in hashtable; used as func in hashtable_iterate
- * @param arg running total of items
- * @param key word
- * @param val dummy item
- */
-static void count_unique_rows(void *arg, const char *key, void *val)
+float *csv_data_avg_probability_new(csv_data_t *csv, int col)
 {
-	if (key != NULL && val != NULL) {
-		++*((int *)arg);
+	if (csv != NULL && csv->avg_probabilities != NULL && col >= 0 && col < csv->cols_n) {
+		float *avg = csv->avg_probabilities[col];
+		if (avg == NULL && (avg = malloc(sizeof(float))) == NULL) {
+			return NULL;
+		}
+
+		int sum = hashtable_get_items_n(*(csv->columns+col)); // Table keeps count, no need to go through it
+		if (csv->typed != NULL && csv->typed[col] != NULL) { // Unique values counted in typed column too
+			sum += typed_column_get_keys_n(csv->typed[col]);
+		}
+		*(avg) = (float)1 / (float)sum;
+		csv->avg_probabilities[col] = avg;
+		return avg;
 	}
+	return NULL;
 }
 
 float **csv_data_get_avg_probabilities(csv_data_t *csv)
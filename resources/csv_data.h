@@ -9,23 +9,86 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "hashtable.h"
+#include "matcher.h"
+#include "typed_column.h"
+#include "candidates.h"
+#include "results.h"
+#include "spill.h"
 
 /* Type definition */
 typedef struct csv_data csv_data_t;
 
 /* Initialize a new struct
- * @param nulls ptr to an ALREADY POPULATED char array of pre-determined null words
- * @param rows number of rows in file, should be supplied by user
+ * @param nulls ALREADY BUILT matcher of pre-determined null words; not freed w/ struct
+ * @param rows number of rows in file, supplied by user (<= 0 if unknown)
  * @return ptr to new struct or NULL if error
  */
-csv_data_t *csv_data_new(char **nulls, int rows);
+csv_data_t *csv_data_new(matcher_t *nulls, int rows);
+
+/* Frees struct and all hashtables/arrays in it, but not null words matcher
+ * @param csv struct to free
+ */
+void csv_data_free(csv_data_t *csv);
 
 /* Get number of rows in file from struct
  * @param csv struct of interest
- * @return number of rows or -1 if error
+ * @return number of rows (<= 0 if unknown) or -1 if error
  */
 int csv_data_get_rows_n(csv_data_t *csv);
 
+/* Set number of rows in file, e.g. once counted
+ * @param csv struct to modify
+ * @param n new rows #
+ * @return n if success, -1 otherwise
+ */
+int csv_data_set_rows_n(csv_data_t *csv, int n);
+
+/* Get number of data rows actually read so far (not incl. header)
+ * @param csv struct of interest
+ * @return number of rows read or -1 if error
+ */
+int csv_data_get_rows_read(csv_data_t *csv);
+
+/* Set number of data rows read, e.g. when combining counts
+ * @param csv struct to modify
+ * @param n new rows read #
+ * @return n if success, -1 otherwise
+ */
+int csv_data_set_rows_read(csv_data_t *csv, int n);
+
+/* Get weight of data rows read so far: same as rows read, unless freqs have been scaled down since
+ * (then scaled down the same), so freq / weight is still a probability
+ * @param csv struct of interest
+ * @return weight or -1 if error
+ */
+double csv_data_get_rows_weight(csv_data_t *csv);
+
+/* Set weight of data rows read
+ * @param csv struct to modify
+ * @param w new weight
+ * @return w if success, -1 otherwise
+ */
+double csv_data_set_rows_weight(csv_data_t *csv, double w);
+
+/* Get lowest freq any word still counted can have (1 unless freqs have been scaled down)
+ * @param csv struct of interest
+ * @return min freq or -1 if error
+ */
+float csv_data_get_min_count(csv_data_t *csv);
+
+/* Set lowest freq any word still counted can have
+ * @param csv struct to modify
+ * @param c new min freq
+ * @return c if success, -1 otherwise
+ */
+float csv_data_set_min_count(csv_data_t *csv, float c);
+
+/* Count another data row read (adds 1 to weight as well)
+ * @param csv struct to modify
+ * @return new rows read # or -1 if error
+ */
+int csv_data_inc_rows_read(csv_data_t *csv);
+
 /* Get number of cols in file from struct
  * @param csv struct of interest
  * @return number of cols or -1 if error
@@ -39,6 +102,13 @@ int csv_data_get_cols_n(csv_data_t *csv);
  */
 int csv_data_set_cols_n(csv_data_t *csv, int n);
 
+/* Make room for more cols in every per-col array made so far (new items NULL for caller to fill in), & set cols #
+ * @param csv csv_data_t to modify
+ * @param n new # cols, at least current #
+ * @return new cols # or -1 if error
+ */
+int csv_data_grow_cols_n(csv_data_t *csv, int n);
+
 /* Get current col we're processing (this can be for anything--while reading csv, iterating through cols hashtable, etc.)
  * @param csv struct of interest
  * @return current col # or -1 if error
@@ -63,9 +133,31 @@ hashtable_t **csv_data_get_columns(csv_data_t *csv);
  */
 hashtable_t **csv_data_new_columns(csv_data_t *csv);
 
-/* Get columns hashtable array
+/* Get typed columns array (one per col, counts values of numeric/date cols)
  * @param csv struct of interest
- * @return ptr to columns, NULL if error
+ * @return ptr to typed columns, NULL if error
+ */
+typed_column_t **csv_data_get_typed(csv_data_t *csv);
+
+/* Initialize typed columns array in struct
+ * @param csv struct of interest
+ */
+typed_column_t **csv_data_new_typed(csv_data_t *csv);
+
+/* Get candidates array (one per col, index of short values in col that could be null words by rarity)
+ * @param csv struct of interest
+ * @return ptr to candidates, NULL if error
+ */
+candidates_t **csv_data_get_candidates(csv_data_t *csv);
+
+/* Initialize candidates array in struct
+ * @param csv struct of interest
+ */
+candidates_t **csv_data_new_candidates(csv_data_t *csv);
+
+/* Get column_to_nulls hashtable array
+ * @param csv struct of interest
+ * @return ptr to column_to_nulls, NULL if error
  */
 hashtable_t **csv_data_get_column_to_nulls(csv_data_t *csv);
 
@@ -74,18 +166,60 @@ hashtable_t **csv_data_get_column_to_nulls(csv_data_t *csv);
  */
 hashtable_t **csv_data_new_column_to_nulls(csv_data_t *csv);
 
-/* Get null words string array
+/* Get column_to_rare hashtable array (null words found by rarity, redone every time results are worked out)
+ * @param csv struct of interest
+ * @return ptr to column_to_rare, NULL if error
+ */
+hashtable_t **csv_data_get_column_to_rare(csv_data_t *csv);
+
+/* Initialize column_to_rare hashtable array in struct
+ * @param csv struct of interest
+ */
+hashtable_t **csv_data_new_column_to_rare(csv_data_t *csv);
+
+/* Get column_to_results array (every null word found in each col w/ its freq, sorted; redone w/ column_to_rare)
+ * @param csv struct of interest
+ * @return ptr to column_to_results, NULL if error
+ */
+results_t **csv_data_get_column_to_results(csv_data_t *csv);
+
+/* Initialize column_to_results array in struct, every item NULL
+ * @param csv struct of interest
+ */
+results_t **csv_data_new_column_to_results(csv_data_t *csv);
+
+/* Get column_to_runs array (each col's freqs spilled to disk so far, NULL for cols never spilled)
  * @param csv struct of interest
- * @return string array or NULL if error
+ * @return ptr to column_to_runs, NULL if error or nothing spilled yet
  */
-char **csv_data_get_nulls(csv_data_t *csv);
+spill_runs_t **csv_data_get_column_to_runs(csv_data_t *csv);
 
-/* Initialize new float array holding average probabilities of words in a col
+/* Initialize column_to_runs array in struct, every item NULL
+ * @param csv struct of interest
+ */
+spill_runs_t **csv_data_new_column_to_runs(csv_data_t *csv);
+
+/* Get null words matcher
+ * @param csv struct of interest
+ * @return matcher or NULL if error
+ */
+matcher_t *csv_data_get_nulls(csv_data_t *csv);
+
+/* Initialize new float array holding average probabilities of words in a col, or get it if already made
+ * Every item starts as NULL; fill each in w/ csv_data_avg_probability_new
  * @param csv struct of interest
  * @return ptr to array or NULL if error
  */
 float **csv_data_avg_probabilities_new(csv_data_t *csv);
 
+/* Calculate (or recalculate) average probability of words in a single col, store it in avg probabilities array
+ * Only touches that col's items, so different cols can be done by different threads at once
+ * @param csv struct of interest, csv_data_avg_probabilities_new must have been called already
+ * @param col index of col (0 is 1st col)
+ * @return ptr to col's avg probability or NULL if error
+ */
+float *csv_data_avg_probability_new(csv_data_t *csv, int col);
+
 /* Get float array holding average probabilities of words in a col
  * @param csv struct of interest
  * @return ptr to array of NULL if error
@@ -0,0 +1,230 @@
+/* Csv dialect's .c file
+ * See .h file for more details on each function
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dialect.h"
+
+#define SNIFF_LINES 32 // Lines looked at when guessing delimiter
+#define DELIMS ",\t;|" // Delimiters guessed among, in order of preference when tied
+
+// Local function declaration
+static int score_delim(const char *buf, size_t len, char delim, char quote, int *per_line);
+static bool is_utf8(const unsigned char *buf, size_t len);
+static bool quotes_fields(const char *buf, size_t len, char quote, char delim);
+
+void dialect_default(dialect_t *dialect)
+{
+	if (dialect != NULL) {
+		dialect->delim = ',';
+		dialect->quote = '"';
+		dialect->strict = false;
+		dialect->encoding = ENCODING_UTF8;
+	}
+}
+
+void dialect_sniff(const char *buf, size_t len, dialect_t *dialect)
+{
+	if (buf == NULL || dialect == NULL || len == 0) {
+		return;
+	}
+
+	// UTF-8 BOM settles encoding
+	if (len >= 3 && memcmp(buf, "\xEF\xBB\xBF", 3) == 0) {
+		dialect->encoding = ENCODING_UTF8;
+		buf += 3;
+		len -= 3;
+	}
+	else {
+		dialect->encoding = is_utf8((const unsigned char *)buf, len) ? ENCODING_UTF8 : ENCODING_LATIN1;
+	}
+
+	// Single quotes only if there are no double quotes at all, otherwise an apostrophe would throw it off
+	char quote = '"';
+	if (memchr(buf, '"', len) == NULL) {
+		for (const char *d = DELIMS; *d != '\0'; d++) {
+			if (quotes_fields(buf, len, '\'', *d)) {
+				quote = '\'';
+				break;
+			}
+		}
+	}
+
+	// Delimiter has to be in header; whichever has the most lines w/ as many as header does wins, ties going to more
+	// fields per line, then order in DELIMS. Delimiter given (comma by default) is kept unless that one's strictly better
+	// on both, since e.g. a column of x;y values in a ragged comma file makes ; look more consistent
+	int kept_per_line;
+	int kept_score = score_delim(buf, len, dialect->delim, quote, &kept_per_line);
+	int best_score = 0;
+	int best_per_line = 0;
+	char best = dialect->delim;
+	for (const char *d = DELIMS; *d != '\0'; d++) {
+		if (*d == dialect->delim) {
+			continue;
+		}
+		int per_line;
+		int score = score_delim(buf, len, *d, quote, &per_line);
+		if (score > best_score || (score == best_score && score > 0 && per_line > best_per_line)) {
+			best_score = score;
+			best_per_line = per_line;
+			best = *d;
+		}
+	}
+	if (best_score > 0 && (kept_score == 0 || (best_score > kept_score && best_per_line > kept_per_line))) {
+		dialect->delim = best;
+	}
+	dialect->quote = quote;
+}
+
+int dialect_parse_opt(char opt, const char *val, dialect_t *dialect)
+{
+	if (val == NULL || dialect == NULL) {
+		return 2;
+	}
+
+	if (opt == 'F') {
+		const char *names[] = {"tab", "comma", "semicolon", "pipe", "space", "\\t"};
+		const char chars[] = {'\t', ',', ';', '|', ' ', '\t'};
+		for (int i = 0; i < (int)sizeof(chars); i++) {
+			if (strcmp(val, names[i]) == 0) {
+				dialect->delim = chars[i];
+				return 0;
+			}
+		}
+		if (strlen(val) == 1 && val[0] != '\n' && val[0] != '\r') {
+			dialect->delim = val[0];
+			return 0;
+		}
+	}
+	else if (opt == 'Q' && strlen(val) == 1 && val[0] != '\n' && val[0] != '\r') {
+		dialect->quote = val[0];
+		return 0;
+	}
+	else if (opt == 'E' && (strcmp(val, "utf8") == 0 || strcmp(val, "utf-8") == 0)) {
+		dialect->encoding = ENCODING_UTF8;
+		return 0;
+	}
+	else if (opt == 'E' && (strcmp(val, "latin1") == 0 || strcmp(val, "iso-8859-1") == 0)) {
+		dialect->encoding = ENCODING_LATIN1;
+		return 0;
+	}
+	else if (opt == 'P' && (strcmp(val, "strict") == 0 || strcmp(val, "lenient") == 0)) {
+		dialect->strict = (strcmp(val, "strict") == 0);
+		return 0;
+	}
+	return 1;
+}
+
+/* Counts delimiter outside quotes in header & each complete line after (up to SNIFF_LINES in all),
+ * & how many lines have as many as header; lines that don't are ragged rows or delimiter's wrong, so say nothing
+ * @param buf start of data, header 1st
+ * @param len # bytes in buf
+ * @param delim delimiter to try
+ * @param quote quote char
+ * @param per_line filled in w/ # delimiters in header
+ * @return # lines (incl. header) w/ as many as header, 0 if header has none
+ */
+static int score_delim(const char *buf, size_t len, char delim, char quote, int *per_line)
+{
+	int lines_n = 0;
+	int same = 0;
+	int count = 0;
+	bool quoted = false;
+	bool blank = true; // Blank lines say nothing
+
+	*per_line = 0;
+	for (size_t i = 0; i < len && lines_n < SNIFF_LINES; i++) {
+		if (buf[i] == quote) {
+			quoted = !quoted; // Doubled quote flips twice, so no need to treat it specially
+		}
+		else if (!quoted && buf[i] == delim) {
+			count++;
+		}
+		else if (!quoted && buf[i] == '\n') {
+			if (!blank) {
+				if (lines_n++ == 0) {
+					*per_line = count;
+				}
+				same += (count == *per_line);
+			}
+			count = 0;
+			blank = true;
+			continue;
+		}
+		if (buf[i] != '\r') {
+			blank = false;
+		}
+	}
+	if (lines_n == 0 && count > 0) { // Only 1 line, & it's cut off or has no newline; best we've got
+		*per_line = count;
+		same = 1;
+	}
+	return (*per_line > 0) ? same : 0;
+}
+
+/* Whether bytes are valid UTF-8; sequence cut off at end of buffer is given benefit of the doubt
+ * @param buf bytes
+ * @param len # bytes
+ * @return true if valid
+ */
+static bool is_utf8(const unsigned char *buf, size_t len)
+{
+	size_t i = 0;
+
+	while (i < len) {
+		int follow;
+		if (buf[i] < 0x80) {
+			i++;
+			continue;
+		}
+		else if (buf[i] >= 0xC2 && buf[i] <= 0xDF) {
+			follow = 1;
+		}
+		else if (buf[i] >= 0xE0 && buf[i] <= 0xEF) {
+			follow = 2;
+		}
+		else if (buf[i] >= 0xF0 && buf[i] <= 0xF4) {
+			follow = 3;
+		}
+		else {
+			return false;
+		}
+		for (int k = 1; k <= follow; k++) {
+			if (i + k >= len) {
+				return true;
+			}
+			if ((buf[i+k] & 0xC0) != 0x80) {
+				return false;
+			}
+		}
+		i += follow + 1;
+	}
+	return true;
+}
+
+/* Whether quote char looks like it surrounds fields: shows up right after a delimiter/line start & right before a delimiter/line end
+ * @param buf start of data
+ * @param len # bytes in buf
+ * @param quote quote char to try
+ * @param delim delimiter to try
+ * @return true if it opens & closes at least 2 fields
+ */
+static bool quotes_fields(const char *buf, size_t len, char quote, char delim)
+{
+	int opens = 0;
+	int closes = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		if (buf[i] == quote) {
+			if (i == 0 || buf[i-1] == delim || buf[i-1] == '\n') {
+				opens++;
+			}
+			if (i+1 == len || buf[i+1] == delim || buf[i+1] == '\n' || buf[i+1] == '\r') {
+				closes++;
+			}
+		}
+	}
+	return opens >= 2 && closes >= 2;
+}
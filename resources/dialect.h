@@ -0,0 +1,50 @@
+/* How a csv file is written: delimiter, quote char, strictness, encoding
+ * Can be given outright or guessed from the first few KB of data
+ */
+
+#ifndef __DIALECT_H
+#define __DIALECT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define SNIFF_SIZE 8192 // Bytes worth looking at to guess dialect
+
+// Encoding of data; fields are counted as UTF-8, so others are converted first
+typedef enum encoding {
+	ENCODING_UTF8, // Also plain ASCII; BOM at start skipped
+	ENCODING_LATIN1
+} encoding_t;
+
+typedef struct dialect {
+	char delim;
+	char quote;
+	bool strict; // Quotes out of place are parse errors instead of just taken as part of field
+	encoding_t encoding;
+} dialect_t;
+
+/* Default dialect: comma, double quotes, lenient, UTF-8
+ * @param dialect filled in
+ */
+void dialect_default(dialect_t *dialect);
+
+/* Guess dialect from start of data: delimiter is whichever one in header shows up as many times (outside quotes) in most
+ * lines, though delimiter dialect starts out w/ is only replaced by one that's in more lines & gives more fields,
+ * quote is ' only if " never shows up but ' surrounds fields, encoding is Latin-1 if not valid UTF-8;
+ * strictness can't be guessed, so it's left as is
+ * @param buf start of data, ideally SNIFF_SIZE bytes (fewer is fine, e.g. short file)
+ * @param len # bytes in buf
+ * @param dialect filled in w/ guess; starts out as whatever caller wants kept if nothing better's found
+ */
+void dialect_sniff(const char *buf, size_t len, dialect_t *dialect);
+
+/* Reads a dialect option value: delimiter as char or tab|comma|semicolon|pipe|space, quote char, encoding utf8|latin1
+ * @param opt which part of dialect: 'F' delimiter, 'Q' quote, 'E' encoding, 'P' strict|lenient
+ * @param val option value
+ * @param dialect updated
+ * @return exit status
+ */
+int dialect_parse_opt(char opt, const char *val, dialect_t *dialect);
+
+#endif
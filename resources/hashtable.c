@@ -5,18 +5,49 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include "hugemem.h"
 #include "hashtable.h"
 
+#define INLINE_KEY 16 // Keys shorter than this are kept right in their node, w/ room for terminator
+#define ARENA_BLOCK 4096 // Min bytes in each arena block for longer keys
+#define NODES_MIN 32 // Nodes in 1st node block; each block after has twice as many, up to NODES_MAX
+#define NODES_MAX 65536
+
 /* Local types */
 /* Every hashtable is essentially an array of linked lists*/
 
+// Short key padded w/ zeroes, so can be compared a whole word at a time
+typedef union inline_key {
+	char str[INLINE_KEY];
+	uint64_t words[INLINE_KEY / sizeof(uint64_t)];
+} inline_key_t;
+
 // Node of linked list
 typedef struct item {
-	char *key;
+	inline_key_t inline_key; // Key itself if short enough
+	char *key; // Points at inline_key, or into arena if key too long
+	size_t len;
 	void *val;
 	struct item *next;
 } item_t;
 
+// Block of memory that longer keys are copied into one after another; blocks linked together
+typedef struct arena_block {
+	struct arena_block *next;
+	size_t size;
+	size_t used;
+	char data[];
+} arena_block_t;
+
+// Block of nodes handed out one after another, so nodes of a table sit together instead of all over the heap
+typedef struct node_block {
+	struct node_block *next;
+	int nodes_n;
+	int used;
+	item_t nodes[];
+} node_block_t;
+
 // Holds head of linked list, number of slot_t in a table == size of table
 typedef struct slot {
 	item_t *head;
@@ -24,12 +55,26 @@ typedef struct slot {
 
 /* Global type */
 typedef struct hashtable {
-	slot_t **slots;
+	slot_t *slots; // Heads right in array, so finding a list takes 1 memory access
 	int slots_n;
+	int items_n; // Once this is a few times slots_n, we double slots
+	arena_block_t *arena; // Longer keys, newest block first
+	size_t arena_used; // Bytes taken up by keys still in table
+	size_t arena_freed; // Bytes taken up by keys since removed, reclaimed once there's enough
+	node_block_t *nodes; // Newest block first
+	size_t nodes_bytes; // Bytes in every node block
+	item_t *free_nodes; // Nodes of removed items, linked through next
 } hashtable_t;
 
 // Local function declaration
-static item_t *get_item(slot_t *slot, const char *key);
+static item_t *get_item(slot_t *slot, const char *key, size_t len, const inline_key_t *packed);
+static int grow(hashtable_t *table);
+static unsigned long hash_len(const char *key, size_t len, int size);
+static char *arena_copy(arena_block_t **arena, const char *key, size_t len);
+static void arena_free(arena_block_t *arena);
+static void compact_arena(hashtable_t *table);
+static item_t *new_node(hashtable_t *table);
+static size_t node_block_size(int nodes_n);
 
 hashtable_t *hashtable_new(int slots_n)
 {
@@ -40,7 +85,14 @@ hashtable_t *hashtable_new(int slots_n)
 		}
 		
 		new->slots_n = slots_n;
-		new->slots = calloc(slots_n, sizeof(slot_t*)); // Nodes made as we insert later
+		new->items_n = 0;
+		new->arena = NULL;
+		new->arena_used = 0;
+		new->arena_freed = 0;
+		new->nodes = NULL;
+		new->nodes_bytes = 0;
+		new->free_nodes = NULL;
+		new->slots = hugemem_alloc(slots_n * sizeof(slot_t)); // Every head NULL
 		if (new->slots == NULL) {
 			free(new);
 			return NULL;
@@ -53,43 +105,49 @@ hashtable_t *hashtable_new(int slots_n)
 	}
 }
 
-int hashtable_insert(hashtable_t *table, char *key, void *val)
+int hashtable_insert(hashtable_t *table, const char *key, void *val)
 {
 	if (table != NULL && key != NULL && val != NULL) {
-		unsigned long slot_i = jenkins_one_at_a_time_hash(key, table->slots_n);
+		size_t len = strlen(key);
+		unsigned long slot_i = hash_len(key, len, table->slots_n);
+		inline_key_t packed = {{0}};
 		
-		if (table->slots[slot_i] == NULL) {
-			table->slots[slot_i] = malloc(sizeof(slot_t));
-			
-			if (table->slots[slot_i] == NULL) {
-				return 4;
-			}
-
-			table->slots[slot_i]->head = NULL;
+		if (len < INLINE_KEY) {
+			memcpy(packed.str, key, len);
 		}
+		
+		item_t *new;
 
-		if (table->slots[slot_i] != NULL) {
-			item_t *new;
-
-			if (get_item(table->slots[slot_i], key) != NULL) { // Existing key
-				return 3;
-			}
-			
-			new = malloc(sizeof(item_t));
+		if (get_item(&table->slots[slot_i], key, len, &packed) != NULL) { // Existing key
+			return 3;
+		}
+		
+		new = new_node(table);
 
-			if (new == NULL) {
-				return 4;
-			}
-			
-			new->key = key;
-			new->val = val;
-			new->next = table->slots[slot_i]->head;
-			table->slots[slot_i]->head = new;
+		if (new == NULL) {
+			return 4;
 		}
-		else {
+		
+		// Own copy of key: short ones in node itself, longer ones in arena
+		new->inline_key = packed;
+		new->key = (len < INLINE_KEY) ? new->inline_key.str : arena_copy(&table->arena, key, len);
+		if (new->key == NULL) {
+			new->next = table->free_nodes;
+			table->free_nodes = new;
 			return 4;
 		}
+		if (len >= INLINE_KEY) {
+			table->arena_used += len + 1;
+		}
+		new->len = len;
+		new->val = val;
+		new->next = table->slots[slot_i].head;
+		table->slots[slot_i].head = new;
+		table->items_n++;
 
+		if (table->items_n > table->slots_n * 2) { // Lists getting long, spread them out
+			grow(table); // Still fine w/o it if can't, just slower
+		}
 	}
 	else {
 		return 2;
@@ -99,20 +157,33 @@ int hashtable_insert(hashtable_t *table, char *key, void *val)
 }
 
 /* Retrieves node associated w/ a key in table if any, otherwise NULL
+ * Short keys are compared as 2 words each, w/o looking at key strings at all
  * @param slot the slot in table to look in
- * @key key to look for
+ * @param key key to look for
+ * @param len key's length
+ * @param packed key padded w/ zeroes, if shorter than INLINE_KEY
  * @return node ptr or NULL
  */
-static item_t *get_item(slot_t *slot, const char *key)
+static item_t *get_item(slot_t *slot, const char *key, size_t len, const inline_key_t *packed)
 {
 	if (slot != NULL && key != NULL) {
 		item_t *found = slot->head;
 
-		while (found != NULL) { // Go through whole list
-			if (strcmp(found->key, key) == 0) {
-				return found;
+		if (len < INLINE_KEY) {
+			while (found != NULL) { // Go through whole list
+				if (found->inline_key.words[0] == packed->words[0] && found->inline_key.words[1] == packed->words[1] && found->len == len) {
+					return found;
+				}
+				found = found->next;
+			}
+		}
+		else {
+			while (found != NULL) {
+				if (found->len == len && memcmp(found->key, key, len) == 0) {
+					return found;
+				}
+				found = found->next;
 			}
-			found = found->next;
 		}
 
 		return NULL; // Not found
@@ -122,16 +193,50 @@ static item_t *get_item(slot_t *slot, const char *key)
 	}
 }
 
+/* Doubles # slots in table, moving existing nodes over into their new slots
+ * @param table table to grow
+ * @return exit status
+ */
+static int grow(hashtable_t *table)
+{
+	int slots_n = table->slots_n * 2;
+	slot_t *slots = (slots_n > 0) ? hugemem_alloc(slots_n * sizeof(slot_t)) : NULL;
+	if (slots == NULL) {
+		return 4;
+	}
+
+	for (int i = 0; i < table->slots_n; i++) {
+		item_t *node = table->slots[i].head;
+
+		while (node != NULL) {
+			item_t *next = node->next;
+			unsigned long slot_i = hash_len(node->key, node->len, slots_n);
+			node->next = slots[slot_i].head;
+			slots[slot_i].head = node;
+			node = next;
+		}
+	}
+	hugemem_free(table->slots, table->slots_n * sizeof(slot_t));
+	table->slots = slots;
+	table->slots_n = slots_n;
+	return 0;
+}
+
 void *hashtable_find(hashtable_t *table, const char *key)
 {
 	if (table != NULL && key != NULL) {
-		unsigned long slot_i = jenkins_one_at_a_time_hash(key, table->slots_n);
+		size_t len = strlen(key);
+		unsigned long slot_i = hash_len(key, len, table->slots_n);
 
-		if (table->slots[slot_i] != NULL) {
-			item_t *found = get_item(table->slots[slot_i], key);
-			if (found != NULL) {
-				return found->val;
-			}
+		inline_key_t packed = {{0}};
+		item_t *found;
+
+		if (len < INLINE_KEY) {
+			memcpy(packed.str, key, len);
+		}
+		found = get_item(&table->slots[slot_i], key, len, &packed);
+		if (found != NULL) {
+			return found->val;
 		}
 		return NULL; // Not found
 	}
@@ -140,19 +245,72 @@ void *hashtable_find(hashtable_t *table, const char *key)
 	}
 }
 
+void hashtable_prefetch(hashtable_t *table, const char *key, size_t len)
+{
+	if (table != NULL && key != NULL) {
+#if defined(__GNUC__)
+		__builtin_prefetch(&table->slots[hash_len(key, len, table->slots_n)], 0, 1);
+#endif
+	}
+}
+
+int hashtable_get_items_n(hashtable_t *table)
+{
+	if (table != NULL) {return table->items_n;}
+	return -1;
+}
+
+size_t hashtable_get_size(hashtable_t *table)
+{
+	if (table != NULL) {
+		// Keys removed but not reclaimed yet still take up their arena space
+		return sizeof(hashtable_t) + table->slots_n * sizeof(slot_t) + table->nodes_bytes + table->arena_used + table->arena_freed;
+	}
+	return 0;
+}
+
 void hashtable_iterate(hashtable_t *table, void *data, void (*func)(void *data, const char *key, void *val))
 {
 	if (table != NULL && func != NULL) {
 		for (int i = 0; i < table->slots_n; i++) {
-			if (table->slots[i] != NULL) {
-				item_t *node = table->slots[i]->head;
+			item_t *node = table->slots[i].head;
+
+			while (node != NULL) {
+				(*func)(data, node->key, node->val);
+				node = node->next;
+			}
+		}
+	}
+}
+
+void hashtable_filter(hashtable_t *table, void *data, bool (*keep)(void *data, const char *key, void *val))
+{
+	if (table != NULL && keep != NULL) {
+		for (int i = 0; i < table->slots_n; i++) {
+			item_t **link = &table->slots[i].head; // Whatever points to node, so can unlink it
 
-				while (node != NULL) {
-					(*func)(data, node->key, node->val);
-					node = node->next;
+			while (*link != NULL) {
+				item_t *node = *link;
+
+				if ((*keep)(data, node->key, node->val)) {
+					link = &node->next;
+				}
+				else {
+					*link = node->next;
+					if (node->len >= INLINE_KEY) {
+						table->arena_used -= node->len + 1;
+						table->arena_freed += node->len + 1;
+					}
+					free(node->val);
+					node->next = table->free_nodes; // Handed out again by next insert
+					table->free_nodes = node;
+					table->items_n--;
 				}
 			}
 		}
+		if (table->arena_freed > ARENA_BLOCK && table->arena_freed > table->arena_used) { // Mostly dead keys, so move live ones over to fresh arena
+			compact_arena(table);
+		}
 	}
 }
 
@@ -160,27 +318,19 @@ void hashtable_free(hashtable_t *table)
 {
 	if (table != NULL) {
 		for (int i = 0; i < table->slots_n; i++) {
-			if (table->slots[i] != NULL) {
-				item_t *node = table->slots[i]->head;
-				
-				while (node != NULL) {
-					if (node->key != NULL) {
-						free(node->key);
-					}
-					
-					if (node->val != NULL) {
-						free(node->val); // Val always primitive type for this proj, just free here
-					}
-					
-					item_t *next = node->next;
-					free(node);
-					node = next;
+			for (item_t *node = table->slots[i].head; node != NULL; node = node->next) {
+				if (node->val != NULL) {
+					free(node->val); // Val always primitive type for this proj, just free here
 				}
-
-				free(table->slots[i]);
 			}
 		}
-		free(table->slots);
+		while (table->nodes != NULL) {
+			node_block_t *next = table->nodes->next;
+			hugemem_free(table->nodes, node_block_size(table->nodes->nodes_n));
+			table->nodes = next;
+		}
+		hugemem_free(table->slots, table->slots_n * sizeof(slot_t));
+		arena_free(table->arena);
 		free(table);
 	}
 }
@@ -190,22 +340,162 @@ void hashtable_print(hashtable_t *table)
 	if (table != NULL) {
 		for (int i = 0; i < table->slots_n; i++) {
 			printf("\n%d: ", i);
-			if (table->slots[i] != NULL) {
-				item_t *node = table->slots[i]->head;
+			item_t *node = table->slots[i].head;
 
-				while (node != NULL) {
-					printf("%s, ", node->key);
-					node = node->next;
-				}
+			while (node != NULL) {
+				printf("%s, ", node->key);
+				node = node->next;
 			}
 		}
 	}
 }
 
 unsigned long jenkins_one_at_a_time_hash(const char* key, int size) {
+	return hash_len(key, strlen(key), size);
+}
+
+/* Copies key into arena, making new block if no room left in newest one
+ * @param arena ptr to newest block, updated if new block made
+ * @param key key to copy
+ * @param len key's length
+ * @return ptr to copy, or NULL if malloc error
+ */
+static char *arena_copy(arena_block_t **arena, const char *key, size_t len)
+{
+	arena_block_t *block = *arena;
+
+	if (block == NULL || block->size - block->used < len + 1) {
+		size_t size = (len + 1 > ARENA_BLOCK) ? len + 1 : ARENA_BLOCK;
+		if ((block = malloc(sizeof(arena_block_t) + size)) == NULL) {
+			return NULL;
+		}
+		block->next = *arena;
+		block->size = size;
+		block->used = 0;
+		*arena = block;
+	}
+
+	char *copy = block->data + block->used;
+	memcpy(copy, key, len);
+	copy[len] = '\0';
+	block->used += len + 1;
+	return copy;
+}
+
+/* Frees every block in arena
+ * @param arena newest block
+ */
+static void arena_free(arena_block_t *arena)
+{
+	while (arena != NULL) {
+		arena_block_t *next = arena->next;
+		free(arena);
+		arena = next;
+	}
+}
+
+/* Copies longer keys still in table into new arena & frees old one, reclaiming space of removed keys
+ * Old arena kept as is if can't
+ * @param table table w/ removed keys
+ */
+static void compact_arena(hashtable_t *table)
+{
+	arena_block_t *arena = NULL;
+
+	// Copy everything first so can back out halfway through
+	for (int i = 0; i < table->slots_n; i++) {
+		for (item_t *node = table->slots[i].head; node != NULL; node = node->next) {
+			if (node->len >= INLINE_KEY && arena_copy(&arena, node->key, node->len) == NULL) {
+				arena_free(arena);
+				return;
+			}
+		}
+	}
+
+	// Keys copied in same order, so just walk through new arena from its oldest block
+	arena_block_t *oldest = NULL;
+	for (arena_block_t *block = arena; block != NULL; ) { // Reverse block list
+		arena_block_t *next = block->next;
+		block->next = oldest;
+		oldest = block;
+		block = next;
+	}
+	arena_block_t *block = oldest;
+	size_t offset = 0;
+	for (int i = 0; i < table->slots_n; i++) {
+		for (item_t *node = table->slots[i].head; node != NULL; node = node->next) {
+			if (node->len >= INLINE_KEY) {
+				if (offset + node->len + 1 > block->used) {
+					block = block->next;
+					offset = 0;
+				}
+				node->key = block->data + offset;
+				offset += node->len + 1;
+			}
+		}
+	}
+	arena = NULL;
+	for (block = oldest; block != NULL; ) { // Back to newest first
+		arena_block_t *next = block->next;
+		block->next = arena;
+		arena = block;
+		block = next;
+	}
+
+	arena_free(table->arena);
+	table->arena = arena;
+	table->arena_freed = 0;
+}
+
+/* Hands out a node, reusing one from a removed item if any, otherwise next one in newest node block
+ * @param table table node's for
+ * @return node or NULL if malloc error
+ */
+static item_t *new_node(hashtable_t *table)
+{
+	item_t *node = table->free_nodes;
+
+	if (node != NULL) {
+		table->free_nodes = node->next;
+		return node;
+	}
+	if (table->nodes == NULL || table->nodes->used == table->nodes->nodes_n) {
+		int nodes_n = (table->nodes == NULL) ? NODES_MIN : table->nodes->nodes_n * 2;
+		if (nodes_n > NODES_MAX) {
+			nodes_n = NODES_MAX;
+		}
+		node_block_t *block = hugemem_alloc(node_block_size(nodes_n));
+		if (block == NULL) {
+			return NULL;
+		}
+		block->next = table->nodes;
+		block->nodes_n = nodes_n;
+		block->used = 0;
+		table->nodes = block;
+		table->nodes_bytes += node_block_size(nodes_n);
+	}
+	return &table->nodes->nodes[table->nodes->used++];
+}
+
+/* Bytes in a node block
+ * @param nodes_n # nodes in block
+ * @return # bytes
+ */
+static size_t node_block_size(int nodes_n)
+{
+	return sizeof(node_block_t) + nodes_n * sizeof(item_t);
+}
+
+/* Jenkins one at a time hash, for key whose length is already known
+ * @param key string used as key
+ * @param len key's length
+ * @param size size of hashtable
+ * @return index to insert into table
+ */
+static unsigned long hash_len(const char *key, size_t len, int size)
+{
 	unsigned long i = 0;
 	unsigned hash = 0;
-	int len = strlen(key);
 
 	while (i != len) {
 		hash += key[i++];
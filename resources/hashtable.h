@@ -8,23 +8,25 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 
 /* Struct definition */
 typedef struct hashtable hashtable_t;
 
 /* Initialize a new hashtable
- * @param number of slots for hashtable
+ * @param number of slots for hashtable to start w/ (doubles as items are inserted, if needed)
  * @return ptr to new hashtable, NULL if error
  */
 hashtable_t *hashtable_new(int slots_n);
 
 /* Insert key, item into hashtable
+ * Table keeps its own copy of key: short ones (< 16 chars) right in the item, longer ones in an arena
  * @param table hashtable to insert into
- * @param key the key for hashing
- * @param item value associated w/ key
+ * @param key the key for hashing, copied
+ * @param item value associated w/ key, owned by table once inserted
  * @return exit status
  */
-int hashtable_insert(hashtable_t *table, char *key, void *item);
+int hashtable_insert(hashtable_t *table, const char *key, void *item);
 
 /* Finds item associated w/ a key in hashtable
  * @param table hashtable to look in
@@ -33,6 +35,25 @@ int hashtable_insert(hashtable_t *table, char *key, void *item);
  */
 void *hashtable_find(hashtable_t *table, const char *key);
 
+/* Start loading slot a key would be in, ahead of looking it up, so lookups of several keys in a row overlap their cache misses
+ * @param table hashtable key will be looked up in
+ * @param key the key
+ * @param len key's length
+ */
+void hashtable_prefetch(hashtable_t *table, const char *key, size_t len);
+
+/* Get # items in hashtable
+ * @param table hashtable of interest
+ * @return # items or -1 if error
+ */
+int hashtable_get_items_n(hashtable_t *table);
+
+/* Get # bytes hashtable itself takes up (slots, nodes & keys), not counting items
+ * @param table hashtable of interest
+ * @return # bytes, 0 if error
+ */
+size_t hashtable_get_size(hashtable_t *table);
+
 /* Iterate through hashtable, applying func to every item
  * @param table hashtable to iterate through
  * @param data whatever user wants to pass to func
@@ -40,6 +61,13 @@ void *hashtable_find(hashtable_t *table, const char *key);
  */
 void hashtable_iterate(hashtable_t *table, void *data, void (*func)(void *data, const char *key, void *item));
 
+/* Removes (& frees) every item func says not to keep
+ * @param table hashtable to filter
+ * @param data whatever user wants to pass to func
+ * @param keep function applied to every item, returning false to remove it; may modify item
+ */
+void hashtable_filter(hashtable_t *table, void *data, bool (*keep)(void *data, const char *key, void *val));
+
 /* Frees up everything in hashtable
  * @param table hashtable to free
  */
@@ -0,0 +1,90 @@
+/* Huge page allocator's .c file
+ * See .h file for more details on each function
+ */
+
+#define _DEFAULT_SOURCE // MAP_ANONYMOUS, MAP_HUGETLB, madvise
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "hugemem.h"
+
+static hugemem_mode_t mode = HUGEMEM_THP;
+
+// Local function declaration
+static size_t round_up(size_t size);
+
+void hugemem_set_mode(hugemem_mode_t new_mode)
+{
+	mode = new_mode;
+}
+
+hugemem_mode_t hugemem_get_mode(void)
+{
+	return mode;
+}
+
+int hugemem_parse_mode(const char *val, hugemem_mode_t *parsed)
+{
+	if (val == NULL || parsed == NULL) {
+		return 2;
+	}
+	const char *names[] = {"off", "thp", "hugetlb"};
+	for (int i = 0; i < 3; i++) {
+		if (strcmp(val, names[i]) == 0) {
+			*parsed = (hugemem_mode_t)i;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+void *hugemem_alloc(size_t size)
+{
+	void *ptr = MAP_FAILED;
+
+	if (size < HUGEMEM_MIN) {
+		return calloc(1, size > 0 ? size : 1);
+	}
+
+	// Mapped in whole huge pages, so munmap works the same however it was backed
+	size = round_up(size);
+#ifdef MAP_HUGETLB
+	if (mode == HUGEMEM_HUGETLB) {
+		ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	}
+#endif
+	if (ptr == MAP_FAILED) { // Not asked for, or pool's empty
+		ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr == MAP_FAILED) {
+			return NULL;
+		}
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+		madvise(ptr, size, (mode == HUGEMEM_OFF) ? MADV_NOHUGEPAGE : MADV_HUGEPAGE); // Only a hint, fine if ignored
+#endif
+	}
+	return ptr; // Anonymous mappings start out zeroed
+}
+
+void hugemem_free(void *ptr, size_t size)
+{
+	if (ptr == NULL) {
+		return;
+	}
+	if (size < HUGEMEM_MIN) {
+		free(ptr);
+	}
+	else {
+		munmap(ptr, round_up(size));
+	}
+}
+
+/* Rounds size up to whole huge pages
+ * @param size # bytes
+ * @return rounded # bytes
+ */
+static size_t round_up(size_t size)
+{
+	return (size + HUGEMEM_MIN - 1) / HUGEMEM_MIN * HUGEMEM_MIN;
+}
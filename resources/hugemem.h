@@ -0,0 +1,50 @@
+/* Big zeroed allocations for tables that are accessed at random (hashtable slots & nodes, typed column arrays)
+ * Anything HUGEMEM_MIN or bigger is mapped on its own so it can be backed by huge pages, cutting TLB misses
+ * on tables that grow into gigabytes; smaller allocations just use calloc
+ */
+
+#ifndef __HUGEMEM_H
+#define __HUGEMEM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HUGEMEM_MIN (2L * 1024 * 1024) // Size of a huge page on most systems
+
+// How big allocations are backed; same for whole process
+typedef enum hugemem_mode {
+	HUGEMEM_OFF, // Regular pages, even if system would give transparent huge pages by default
+	HUGEMEM_THP, // Ask for transparent huge pages (madvise) (default)
+	HUGEMEM_HUGETLB // Explicit huge pages from pool set aside by admin (MAP_HUGETLB), THP if pool's empty
+} hugemem_mode_t;
+
+/* Set how big allocations made from now on are backed
+ * @param mode one of hugemem_mode_t
+ */
+void hugemem_set_mode(hugemem_mode_t mode);
+
+/* Get how big allocations are backed
+ * @return mode
+ */
+hugemem_mode_t hugemem_get_mode(void);
+
+/* Reads a huge pages option value
+ * @param val off|thp|hugetlb
+ * @param mode filled in
+ * @return exit status
+ */
+int hugemem_parse_mode(const char *val, hugemem_mode_t *mode);
+
+/* Allocate zeroed memory, w/ huge pages if big enough
+ * @param size # bytes
+ * @return ptr to memory or NULL if error
+ */
+void *hugemem_alloc(size_t size);
+
+/* Free memory from hugemem_alloc
+ * @param ptr memory to free (NULL is fine)
+ * @param size same # bytes it was allocated w/
+ */
+void hugemem_free(void *ptr, size_t size);
+
+#endif
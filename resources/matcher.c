@@ -0,0 +1,391 @@
+/* Dictionary matcher's .c file
+ * See .h file for more details on each function
+ */
+
+#define _POSIX_C_SOURCE 200809L // getline
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "utf8.h"
+#include "matcher.h"
+
+/* Global type */
+/* States of the automaton are numbered 0 (root) up; every state has a transition for every byte,
+ * so matching never has to follow failure links. Bytes that act the same (all those in no null word,
+ * most of them) share a class & a column of transitions, so the table stays small enough for L1 */
+typedef struct matcher {
+	unsigned short classes[256]; // Class of each byte, 0 for bytes in no null word
+	int classes_n;
+	int *next; // next[state * classes_n + class] = state to go to
+	size_t *longest; // Length of longest null word ending at each state (0 if none)
+	int states_n;
+	char **words; // Copy of null words
+	int words_n;
+	size_t max_len; // Length of longest null word
+	bool borrowed; // Tables & words belong to a matcher_tables_t compiled in, not freed w/ matcher
+} matcher_t;
+
+// Local function declaration
+static int add_state(matcher_t *matcher, int *cap);
+static void write_string(FILE *out, const char *str);
+static int read_words(const char *file, char ***words, int *words_n);
+
+matcher_t *matcher_new(char **words, int words_n)
+{
+	if (words == NULL || words_n < 0) {
+		return NULL;
+	}
+
+	matcher_t *new = malloc(sizeof(matcher_t));
+	if (new == NULL) {
+		return NULL;
+	}
+	int cap = 0; // States allocated room for
+	new->classes_n = 1;
+	new->next = NULL;
+	new->longest = NULL;
+	new->states_n = 0;
+	new->words_n = words_n;
+	new->max_len = 0;
+	new->borrowed = false;
+	if ((new->words = calloc(words_n > 0 ? words_n : 1, sizeof(char*))) == NULL) {
+		free(new);
+		return NULL;
+	}
+
+	// Fold words, giving every byte they use its own class
+	memset(new->classes, 0, sizeof(new->classes));
+	for (int i = 0; i < words_n; i++) {
+		if (words[i] == NULL) {
+			continue;
+		}
+		size_t len = strlen(words[i]);
+
+		if ((new->words[i] = malloc(len+1)) == NULL) {
+			matcher_free(new);
+			return NULL;
+		}
+		len = utf8_fold(words[i], len, new->words[i]); // Fields are folded the same way before matching
+		new->words[i][len] = '\0';
+		if (len > new->max_len) {
+			new->max_len = len;
+		}
+		for (size_t j = 0; j < len; j++) {
+			new->classes[(unsigned char)new->words[i][j]] = 1;
+		}
+	}
+	for (int c = 0; c < 256; c++) {
+		if (new->classes[c] != 0) {
+			new->classes[c] = (unsigned short)new->classes_n++;
+		}
+	}
+
+	// Build trie of words, -1 meaning no transition yet
+	if (add_state(new, &cap) != 0) {
+		matcher_free(new);
+		return NULL;
+	}
+	for (int i = 0; i < words_n; i++) {
+		if (new->words[i] == NULL) {
+			continue;
+		}
+		size_t len = strlen(new->words[i]);
+		int state = 0;
+
+		for (size_t j = 0; j < len; j++) {
+			int *to = &new->next[state * new->classes_n + new->classes[(unsigned char)new->words[i][j]]];
+			if (*to < 0) {
+				int added = new->states_n;
+				if (add_state(new, &cap) != 0) {
+					matcher_free(new);
+					return NULL;
+				}
+				to = &new->next[state * new->classes_n + new->classes[(unsigned char)new->words[i][j]]]; // Table may have moved
+				*to = added;
+			}
+			state = *to;
+		}
+		if (len > new->longest[state]) {
+			new->longest[state] = len;
+		}
+	}
+
+	// Breadth-first through trie, filling in missing transitions from failure state
+	// and carrying longest word down failure links
+	int *fail = calloc(new->states_n, sizeof(int));
+	int *queue = calloc(new->states_n, sizeof(int));
+	if (fail == NULL || queue == NULL) {
+		free(fail);
+		free(queue);
+		matcher_free(new);
+		return NULL;
+	}
+	int head = 0;
+	int tail = 0;
+
+	for (int c = 0; c < new->classes_n; c++) {
+		int child = new->next[c];
+		if (child < 0) {
+			new->next[c] = 0;
+		}
+		else {
+			fail[child] = 0;
+			queue[tail++] = child;
+		}
+	}
+	while (head < tail) {
+		int state = queue[head++];
+		int *row = &new->next[state * new->classes_n];
+		int *fail_row = &new->next[fail[state] * new->classes_n];
+
+		if (new->longest[fail[state]] > new->longest[state]) {
+			new->longest[state] = new->longest[fail[state]];
+		}
+		for (int c = 0; c < new->classes_n; c++) {
+			int child = row[c];
+			if (child < 0) {
+				row[c] = fail_row[c];
+			}
+			else {
+				fail[child] = fail_row[c];
+				queue[tail++] = child;
+			}
+		}
+	}
+	free(fail);
+	free(queue);
+
+	return new;
+}
+
+matcher_t *matcher_from_tables(const matcher_tables_t *tables)
+{
+	if (tables == NULL || tables->next == NULL || tables->longest == NULL || tables->words == NULL) {
+		return NULL;
+	}
+
+	matcher_t *new = malloc(sizeof(matcher_t));
+	if (new == NULL) {
+		return NULL;
+	}
+	memcpy(new->classes, tables->classes, sizeof(new->classes));
+	new->classes_n = tables->classes_n;
+	// Never written once built, so const tables can stand in for built ones
+	new->next = (int*)tables->next;
+	new->longest = (size_t*)tables->longest;
+	new->states_n = tables->states_n;
+	new->words = (char**)tables->words;
+	new->words_n = tables->words_n;
+	new->max_len = tables->max_len;
+	new->borrowed = true;
+	return new;
+}
+
+matcher_t *matcher_load(const char *file)
+{
+	char **words;
+	int words_n = 0;
+	matcher_t *new = NULL;
+
+	if (file == NULL) {
+		return NULL;
+	}
+	if (read_words(file, &words, &words_n) == 0) {
+		new = matcher_new(words, words_n); // Has its own copy of words
+	}
+	for (int i = 0; i < words_n; i++) {
+		free(words[i]);
+	}
+	free(words);
+	return new;
+}
+
+int matcher_write_tables(const matcher_t *matcher, const char *name, FILE *out)
+{
+	if (matcher == NULL || name == NULL || out == NULL) {
+		return 2;
+	}
+
+	fprintf(out, "#include \"matcher.h\"\n\n");
+	fprintf(out, "static const int %s_next[%d] = {", name, matcher->states_n * matcher->classes_n);
+	for (int i = 0; i < matcher->states_n * matcher->classes_n; i++) {
+		fprintf(out, "%s%d,", (i % matcher->classes_n == 0) ? "\n\t" : " ", matcher->next[i]);
+	}
+	fprintf(out, "\n};\n\nstatic const size_t %s_longest[%d] = {", name, matcher->states_n);
+	for (int i = 0; i < matcher->states_n; i++) {
+		fprintf(out, "%s%zu,", (i % 16 == 0) ? "\n\t" : " ", matcher->longest[i]);
+	}
+	fprintf(out, "\n};\n\nstatic const char *const %s_words[%d] = {\n", name, matcher->words_n > 0 ? matcher->words_n : 1);
+	for (int i = 0; i < matcher->words_n; i++) {
+		fprintf(out, "\t");
+		write_string(out, matcher->words[i]);
+		fprintf(out, ",\n");
+	}
+	if (matcher->words_n == 0) {
+		fprintf(out, "\tNULL,\n");
+	}
+	fprintf(out, "};\n\nconst matcher_tables_t %s = {\n\t{", name);
+	for (int c = 0; c < 256; c++) {
+		fprintf(out, "%s%hu,", (c % 32 == 0) ? "\n\t\t" : " ", matcher->classes[c]);
+	}
+	fprintf(out, "\n\t},\n\t%d, %s_next, %s_longest, %d,\n", matcher->classes_n, name, name, matcher->states_n);
+	fprintf(out, "\t%s_words, %d, %zu\n};\n", name, matcher->words_n, matcher->max_len);
+
+	return ferror(out) ? 4 : 0;
+}
+
+size_t matcher_longest(const matcher_t *matcher, const char *text, size_t len)
+{
+	size_t longest = 0;
+
+	if (matcher != NULL && text != NULL) {
+		int state = 0;
+
+		for (size_t i = 0; i < len; i++) {
+			state = matcher->next[state * matcher->classes_n + matcher->classes[(unsigned char)text[i]]];
+			if (matcher->longest[state] > longest) {
+				longest = matcher->longest[state];
+			}
+		}
+	}
+	return longest;
+}
+
+bool matcher_has_word_of(const matcher_t *matcher, const char *chars)
+{
+	if (matcher != NULL && chars != NULL) {
+		for (int i = 0; i < matcher->words_n; i++) {
+			if (matcher->words[i] != NULL && matcher->words[i][0] != '\0' && strspn(matcher->words[i], chars) == strlen(matcher->words[i])) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+int matcher_get_words_n(const matcher_t *matcher)
+{
+	if (matcher != NULL) {return matcher->words_n;}
+	return -1;
+}
+
+size_t matcher_get_max_len(const matcher_t *matcher)
+{
+	if (matcher != NULL) {return matcher->max_len;}
+	return 0;
+}
+
+void matcher_free(matcher_t *matcher)
+{
+	if (matcher != NULL) {
+		if (!matcher->borrowed) {
+			for (int i = 0; i < matcher->words_n; i++) {
+				free(matcher->words[i]);
+			}
+			free(matcher->words);
+			free(matcher->next);
+			free(matcher->longest);
+		}
+		free(matcher);
+	}
+}
+
+/* Adds a new state w/ no transitions, making room if needed
+ * @param matcher matcher to add to
+ * @param cap # states there's currently room for, updated if grown
+ * @return exit status
+ */
+static int add_state(matcher_t *matcher, int *cap)
+{
+	if (matcher->states_n == *cap) {
+		int new_cap = (*cap == 0) ? 64 : *cap * 2;
+		int *next = realloc(matcher->next, (size_t)new_cap * matcher->classes_n * sizeof(int));
+		if (next == NULL) {
+			return 4;
+		}
+		matcher->next = next;
+		size_t *longest = realloc(matcher->longest, new_cap * sizeof(size_t));
+		if (longest == NULL) {
+			return 4;
+		}
+		matcher->longest = longest;
+		*cap = new_cap;
+	}
+
+	memset(&matcher->next[matcher->states_n * matcher->classes_n], -1, matcher->classes_n * sizeof(int));
+	matcher->longest[matcher->states_n] = 0;
+	matcher->states_n++;
+	return 0;
+}
+
+/* Writes string out as a C string literal, bytes other than plain printable ASCII escaped
+ * @param out where to write
+ * @param str string to write, NULL written as NULL
+ */
+static void write_string(FILE *out, const char *str)
+{
+	if (str == NULL) {
+		fprintf(out, "NULL");
+		return;
+	}
+	fputc('"', out);
+	for (const unsigned char *c = (const unsigned char*)str; *c != '\0'; c++) {
+		if (*c < ' ' || *c > '~' || *c == '"' || *c == '\\' || *c == '?') { // ? in case of trigraphs
+			fprintf(out, "\\%03o", *c);
+		}
+		else {
+			fputc(*c, out);
+		}
+	}
+	fputc('"', out);
+}
+
+/* Reads words in null file into a growing array
+ * @param file path to null file
+ * @param words filled in w/ malloc'd array of malloc'd words, NULL if none; words read so far even if error
+ * @param words_n filled in w/ # words read
+ * @return exit status
+ */
+static int read_words(const char *file, char ***words, int *words_n)
+{
+	FILE *fp;
+	char *line = NULL; // Each line we read, one at a time
+	size_t line_cap = 0;
+	ssize_t len;
+	int cap = 0; // Words allocated room for
+	int stat = 0;
+
+	*words = NULL;
+	*words_n = 0;
+	if ((fp = fopen(file, "r")) == NULL) {
+		return 4;
+	}
+	while ((len = getline(&line, &line_cap, fp)) != -1) {
+		while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) {
+			line[--len] = '\0';
+		}
+		if (len == 0) { // In case multiple newlines btwn words
+			continue;
+		}
+		if (*words_n == cap) {
+			int grown_cap = cap > 0 ? cap * 2 : 16;
+			char **grown = realloc(*words, grown_cap * sizeof(char*));
+			if (grown == NULL) {
+				stat = 4;
+				break;
+			}
+			*words = grown;
+			cap = grown_cap;
+		}
+		if (((*words)[*words_n] = malloc(len+1)) == NULL) {
+			stat = 4;
+			break;
+		}
+		strcpy((*words)[(*words_n)++], line);
+	}
+	free(line);
+	fclose(fp);
+	return stat;
+}
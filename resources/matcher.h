@@ -0,0 +1,91 @@
+/* Dictionary matcher for pre-defined null words
+ * Built once from the null words, then finds which of them show up inside a field in a single pass
+ * over the field (Aho-Corasick automaton), rather than a strstr per null word
+ * Read-only once built, so one matcher can be shared by any # of threads/analyzers
+ * A built matcher can also be written out as C source & compiled into a program (see gen_nulls.c),
+ * so a fixed dictionary costs nothing to load
+ */
+
+#ifndef __MATCHER_H
+#define __MATCHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+/* Type definition */
+typedef struct matcher matcher_t;
+
+// Built matcher laid out as plain arrays, as written by matcher_write_tables
+typedef struct matcher_tables {
+	unsigned short classes[256]; // Class of each byte, 0 for bytes in no null word
+	int classes_n;
+	const int *next; // next[state * classes_n + class] = state to go to
+	const size_t *longest; // Length of longest null word ending at each state
+	int states_n;
+	const char *const *words; // Null words, case folded
+	int words_n;
+	size_t max_len;
+} matcher_tables_t;
+
+/* Build a new matcher from null words
+ * @param words array of null words (copied case folded w/ utf8_fold, can be freed after)
+ * @param words_n # words in array
+ * @return ptr to new matcher or NULL if error
+ */
+matcher_t *matcher_new(char **words, int words_n);
+
+/* Wrap tables compiled into program as a matcher, w/o copying or building anything
+ * @param tables tables written by matcher_write_tables, must outlive matcher
+ * @return ptr to new matcher or NULL if error
+ */
+matcher_t *matcher_from_tables(const matcher_tables_t *tables);
+
+/* Build a new matcher from a null words file, one word per line (any length, \r\n endings ok, blank lines skipped)
+ * Used by find_null at runtime & gen_nulls at build time, so both read files the same
+ * @param file path to null file
+ * @return ptr to new matcher or NULL if error
+ */
+matcher_t *matcher_load(const char *file);
+
+/* Write matcher out as C source defining a matcher_tables_t, to be compiled in & passed to matcher_from_tables
+ * @param matcher matcher to write
+ * @param name name of matcher_tables_t variable defined (& prefix of arrays it points to)
+ * @param out where to write source
+ * @return exit status
+ */
+int matcher_write_tables(const matcher_t *matcher, const char *name, FILE *out);
+
+/* Find longest null word that shows up anywhere inside text
+ * @param matcher matcher to use
+ * @param text string to look in (need not be null-terminated)
+ * @param len length of text
+ * @return length of longest null word found in text, 0 if none or error
+ */
+size_t matcher_longest(const matcher_t *matcher, const char *text, size_t len);
+
+/* Whether some null word is made up only of given chars, e.g. to see if numbers could ever be null words
+ * @param matcher matcher of interest
+ * @param chars string of chars allowed
+ * @return true if some word has no chars other than those in chars
+ */
+bool matcher_has_word_of(const matcher_t *matcher, const char *chars);
+
+/* Get # null words matcher was built from
+ * @param matcher matcher of interest
+ * @return # words or -1 if error
+ */
+int matcher_get_words_n(const matcher_t *matcher);
+
+/* Get length of longest null word matcher was built from (in bytes, once case folded)
+ * @param matcher matcher of interest
+ * @return length or 0 if error
+ */
+size_t matcher_get_max_len(const matcher_t *matcher);
+
+/* Frees up matcher
+ * @param matcher matcher to free
+ */
+void matcher_free(matcher_t *matcher);
+
+#endif
@@ -0,0 +1,1496 @@
+/* Library for finding null-equivalent words in csv data
+ * See .h file for more details on each function
+ *
+ * Null words are detected 2 ways, per column:
+ * - field contains one of pre-defined null words & is short enough (found while reading)
+ * - field shows up w/ much lower probability than avg word in column (found when finalizing)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "hashtable.h"
+#include "csv.h"
+#include "csv_data.h"
+#include "workpool.h"
+#include "dialect.h"
+#include "utf8.h"
+#include "spill.h"
+#include "nullfinder.h"
+
+#define DEFAULT_SLOTS 1024 // Slots per column table when rows # not known up front
+#define RARE_SLOTS 64 // Slots per column table of words found by rarity; usually only a handful
+#define TYPED_CHARS "0123456789.-" // Every char a typed value can have
+#define PREFETCH_AHEAD 4 // Fields ahead whose column slot is loaded while counting one
+#define MEMORY_CHECK_ROWS 1024 // Rows between checks of how much memory column tables take up, if there's a limit
+#define COUNT_BYTES 32 // Heap space a word's malloc'd freq takes up, w/ allocator overhead
+
+/* Global type */
+typedef struct nullfinder {
+	struct csv_parser parser; // libcsv parser for raw bytes fed in
+	csv_data_t *info; // Holds hashtables of values in columns, null values in columns, other info about csv
+	matcher_t *own_nulls; // Null words matcher if we built it ourselves (freed w/ analyzer), NULL if shared
+	int threads_n; // # threads to finalize w/
+	bool finalized; // Nothing more can be fed once true
+	bool evaluated; // Results worked out at least once, so can be iterated through
+	int width; // # fields in header, what every row should have (0 until header read)
+	bad_rows_t bad_rows; // What to do w/ rows that don't have width fields
+	FILE *quarantine; // Where rows left out go, if quarantining
+	char *row; // Fields of row being read, back to back, if row has to be seen whole before counting it
+	size_t row_len;
+	size_t row_cap;
+	size_t *field_ends; // Where each field in row ends
+	int fields_n;
+	int fields_cap;
+	bool resync; // Skipping rest of a line that couldn't be parsed
+	bool fed; // Anything fed in yet
+	bool prefetch; // Whole rows held even when counting bad rows, so column slots can be prefetched a few fields ahead
+	size_t memory_limit; // Bytes column tables can take up before biggest are spilled to disk, 0 if no limit
+	spill_file_t *spill; // Where spilled runs go, made on 1st spill
+	encoding_t encoding; // Fields converted to UTF-8 if anything else
+	char *conv; // Field converted to UTF-8
+	size_t conv_cap;
+	int bad_rows_n; // Rows that didn't have width fields
+	int parse_errors_n; // Times parser gave up on data
+	long skipped_n; // Bytes skipped after parse errors
+} nullfinder_t;
+
+/* Local types */
+
+// Everything a worker needs to finish off one column; each column gets its own so no shared cursor
+typedef struct col_job {
+	csv_data_t *info; // Holds hashtable arrays, shared but each column only touches its own items
+	int col; // Index of column (0 is 1st col)
+	float rows; // Total rows in csv, for turning freqs into probabilities
+} col_job_t;
+
+// Tables to move or merge column values into
+typedef struct move_job {
+	hashtable_t *column; // String table, for values that don't fit typed column
+	typed_column_t *typed; // Typed column, tried first
+	candidates_t *cands; // Index of short values, new values put in string table get added
+	int stat;
+} move_job_t;
+
+// For passing user's func & data through results_iterate
+typedef struct result_job {
+	void *data;
+	void (*func)(void *data, const char *word);
+} result_job_t;
+
+// For gathering a col's null words & their freqs into its results
+typedef struct collect_job {
+	results_t *results;
+	hashtable_t *column; // Freqs of strings
+	typed_column_t *typed; // Freqs of typed values
+	hashtable_t *skip; // Words gathered already, NULL if none
+	int stat;
+} collect_job_t;
+
+// For gathering a col's words & freqs to spill
+typedef struct gather_job {
+	spill_item_t *items;
+	int items_n;
+	char (*copies)[TYPED_KEY_MAX]; // Typed values printed back, since typed column only prints them into a temp buffer
+	int copies_n;
+} gather_job_t;
+
+// For going through a spilled col's merged runs
+typedef struct merged_job {
+	csv_data_t *info;
+	int col;
+	float rows; // Total rows in csv, for turning freqs into probabilities
+	float avg; // Avg probability of words in col, once counted
+	bool rare_possible; // Whether a word seen min_count times would be rare enough; if not, no need to check
+	int words_n; // Unique words, counted in 1st pass
+	results_t *results;
+	int stat;
+} merged_job_t;
+
+// For scaling down freqs in a column table
+typedef struct decay_job {
+	float factor;
+	float min_count; // Lower than this & word's dropped
+	hashtable_t *column; // Column table, for checking null words are still counted
+} decay_job_t;
+
+// Local function declaration
+static void on_field_read(void *s, size_t len, void *data);
+static void on_row_read(int c, void *data);
+static void count_field(nullfinder_t *nf, char *s, size_t len);
+static void count_row(nullfinder_t *nf);
+static bool is_typed(csv_data_t *info, int col);
+static void end_row(nullfinder_t *nf);
+static void reject_row(nullfinder_t *nf, bool whole);
+static int reset_parser(nullfinder_t *nf);
+static size_t skip_line(nullfinder_t *nf, const char *buf, size_t len);
+static char *to_utf8(nullfinder_t *nf, char *s, size_t *len);
+static bool is_rare(float prob, float avg);
+static bool is_candidate(const char *key);
+static void index_candidate(void *data, const char *key, void *val);
+static void find_nulls_by_probabilities(void *data, const char *key, void *val);
+static void finalize_column(void *data, int col);
+static void find_rare(csv_data_t *info, int col);
+static void collect_results(csv_data_t *info, int col);
+static void collect_result(void *data, const char *key, void *val);
+static void pass_result(void *data, const char *word, float count);
+static int evaluate(nullfinder_t *nf);
+static bool decay_count(void *data, const char *key, void *val);
+static bool still_counted(void *data, const char *key, void *val);
+static int setup_columns(csv_data_t *info, int cols_n);
+static void merge_count(void *data, const char *key, void *val);
+static void decide_types(csv_data_t *info);
+static void merge_null(void *data, const char *key, void *val);
+static size_t column_size(csv_data_t *info, int col);
+static bool is_spilled(csv_data_t *info, int col);
+static int check_memory(nullfinder_t *nf);
+static int spill_column(nullfinder_t *nf, int col);
+static void gather_item(void *data, const char *key, void *val);
+static void gather_typed(void *data, const char *key, void *val);
+static void finalize_spilled(csv_data_t *info, int col);
+static void count_merged(void *data, const char *key, float count);
+static void collect_merged(void *data, const char *key, float count);
+
+nullfinder_t *nullfinder_new(char **null_words, int nulls_n, int rows)
+{
+	matcher_t *nulls = matcher_new(null_words, nulls_n);
+	if (nulls == NULL) {
+		return NULL;
+	}
+
+	nullfinder_t *new = nullfinder_new_shared(nulls, rows);
+	if (new == NULL) {
+		matcher_free(nulls);
+		return NULL;
+	}
+	new->own_nulls = nulls;
+
+	return new;
+}
+
+nullfinder_t *nullfinder_new_shared(matcher_t *nulls, int rows)
+{
+	if (nulls == NULL) {
+		return NULL;
+	}
+
+	nullfinder_t *new = malloc(sizeof(nullfinder_t));
+	if (new == NULL) {
+		return NULL;
+	}
+
+	if ((new->info = csv_data_new(nulls, rows)) == NULL) {
+		free(new);
+		return NULL;
+	}
+	if (csv_init(&new->parser, 0) != 0) {
+		csv_data_free(new->info);
+		free(new);
+		return NULL;
+	}
+	new->own_nulls = NULL;
+	new->threads_n = workpool_default_threads();
+	new->finalized = false;
+	new->evaluated = false;
+	new->width = 0;
+	new->bad_rows = BAD_ROWS_COUNT;
+	new->prefetch = false;
+	new->memory_limit = 0;
+	new->spill = NULL;
+	new->quarantine = NULL;
+	new->row = NULL;
+	new->row_len = 0;
+	new->row_cap = 0;
+	new->field_ends = NULL;
+	new->fields_n = 0;
+	new->fields_cap = 0;
+	new->resync = false;
+	new->fed = false;
+	new->encoding = ENCODING_UTF8;
+	new->conv = NULL;
+	new->conv_cap = 0;
+	new->bad_rows_n = 0;
+	new->parse_errors_n = 0;
+	new->skipped_n = 0;
+
+	return new;
+}
+
+int nullfinder_set_threads(nullfinder_t *nf, int threads_n)
+{
+	if (nf != NULL && threads_n > 0) {
+		nf->threads_n = threads_n;
+		return 0;
+	}
+	return 2;
+}
+
+int nullfinder_set_cols_n(nullfinder_t *nf, int cols_n)
+{
+	if (nf == NULL || cols_n <= 0 || nf->finalized || csv_data_get_cols_n(nf->info) != 0) {
+		return 2;
+	}
+	nf->width = cols_n;
+	return setup_columns(nf->info, cols_n);
+}
+
+int nullfinder_set_dialect(nullfinder_t *nf, const dialect_t *dialect)
+{
+	if (nf == NULL || dialect == NULL || nf->fed || nf->finalized) {
+		return 2;
+	}
+	if (dialect->delim == dialect->quote || dialect->delim == '\n' || dialect->delim == '\r') {
+		return 1;
+	}
+
+	// Straight into parser, which keeps them if it's ever started over
+	csv_set_opts(&nf->parser, dialect->strict ? CSV_STRICT : 0);
+	csv_set_delim(&nf->parser, (unsigned char)dialect->delim);
+	csv_set_quote(&nf->parser, (unsigned char)dialect->quote);
+	nf->encoding = dialect->encoding;
+	return 0;
+}
+
+int nullfinder_set_bad_rows(nullfinder_t *nf, bad_rows_t policy, FILE *quarantine)
+{
+	if (nf == NULL || (policy == BAD_ROWS_QUARANTINE && quarantine == NULL) || nf->finalized) {
+		return 2;
+	}
+	if (policy != BAD_ROWS_COUNT && policy != BAD_ROWS_SKIP && policy != BAD_ROWS_QUARANTINE) {
+		return 1;
+	}
+	nf->bad_rows = policy;
+	nf->quarantine = (policy == BAD_ROWS_QUARANTINE) ? quarantine : NULL;
+	return 0;
+}
+
+int nullfinder_set_prefetch(nullfinder_t *nf, bool prefetch)
+{
+	if (nf == NULL || nf->fed || nf->finalized) {
+		return 2;
+	}
+	nf->prefetch = prefetch;
+	return 0;
+}
+
+int nullfinder_set_memory_limit(nullfinder_t *nf, size_t bytes)
+{
+	if (nf == NULL || nf->finalized) {
+		return 2;
+	}
+	nf->memory_limit = bytes;
+	return 0;
+}
+
+int nullfinder_spill(nullfinder_t *nf)
+{
+	if (nf == NULL || nf->finalized) {
+		return 2;
+	}
+	for (int i = 0; i < csv_data_get_cols_n(nf->info); i++) {
+		int stat = spill_column(nf, i);
+		if (stat != 0) {
+			return stat;
+		}
+	}
+	return 0;
+}
+
+int nullfinder_feed(nullfinder_t *nf, const char *buf, size_t len)
+{
+	if (nf == NULL || buf == NULL || nf->finalized) {
+		return 2;
+	}
+
+	size_t done = 0;
+	if (!nf->fed && nf->encoding == ENCODING_UTF8 && len >= 3 && memcmp(buf, "\xEF\xBB\xBF", 3) == 0) { // BOM isn't part of 1st field
+		done = 3;
+	}
+	nf->fed = true;
+	while (done < len) {
+		if (nf->resync) { // Rest of a bad line is skipped, parsing picks up again on next one
+			if (nf->quarantine != NULL) {
+				flockfile(nf->quarantine);
+			}
+			done += skip_line(nf, buf+done, len-done);
+			if (nf->quarantine != NULL) {
+				funlockfile(nf->quarantine);
+			}
+			continue;
+		}
+
+		// Callback functions called w/ every field & row read to populate hashtables of words in each column & null words in each column
+		done += csv_parse(&nf->parser, buf+done, len-done, on_field_read, on_row_read, nf);
+		if (done < len) { // Parser gave up; drop row it was in the middle of & start over from next line
+			nf->parse_errors_n++;
+			if (nf->bad_rows == BAD_ROWS_COUNT && nf->fields_n > 0) { // Only held for prefetching, so counted as usual
+				count_row(nf);
+			}
+			csv_data_set_col_curr(nf->info, 0);
+			if (reset_parser(nf) != 0) {
+				return 4;
+			}
+			if (nf->quarantine != NULL) { // Partial row & what's left of its line go out together
+				flockfile(nf->quarantine);
+			}
+			if (nf->fields_n > 0) {
+				reject_row(nf, false);
+			}
+			done += skip_line(nf, buf+done, len-done);
+			if (nf->quarantine != NULL) {
+				funlockfile(nf->quarantine);
+			}
+		}
+	}
+	return 0;
+}
+
+int nullfinder_feed_row(nullfinder_t *nf, const char **fields, const size_t *lens, int fields_n)
+{
+	if (nf == NULL || fields == NULL || lens == NULL || nf->finalized) {
+		return 2;
+	}
+	nf->fed = true;
+
+	// Same callbacks as raw bytes get, as if libcsv had split them
+	for (int i = 0; i < fields_n; i++) {
+		if (fields[i] == NULL) {
+			return 2;
+		}
+	}
+	for (int i = 0; i < fields_n; i++) {
+		on_field_read((void *)fields[i], lens[i], nf);
+	}
+	on_row_read('\n', nf);
+	return 0;
+}
+
+int nullfinder_finalize(nullfinder_t *nf)
+{
+	if (nf == NULL || nf->finalized) {
+		return 2;
+	}
+
+	// Flush out last row in case no newline at end of data
+	if (!nf->resync) {
+		csv_fini(&nf->parser, on_field_read, on_row_read, nf);
+	}
+	nf->finalized = true;
+
+	return evaluate(nf);
+}
+
+int nullfinder_evaluate(nullfinder_t *nf)
+{
+	if (nf == NULL || nf->finalized) {
+		return 2;
+	}
+	return evaluate(nf);
+}
+
+int nullfinder_decay(nullfinder_t *nf, float factor, float min_count)
+{
+	if (nf == NULL || nf->finalized || factor <= 0 || factor > 1 || min_count < 0) {
+		return 2;
+	}
+	csv_data_t *info = nf->info;
+
+	for (int i = 0; i < csv_data_get_cols_n(info); i++) {
+		hashtable_t *column = *(csv_data_get_columns(info) + i);
+		candidates_t *cands = *(csv_data_get_candidates(info) + i);
+		decay_job_t job = {factor, min_count, column};
+
+		hashtable_filter(column, &job, decay_count);
+		typed_column_decay(*(csv_data_get_typed(info) + i), factor, min_count);
+		// Dropped words are gone from index too, so just index what's left
+		candidates_clear(cands);
+		hashtable_iterate(column, cands, index_candidate);
+		if (is_spilled(info, i)) { // Freqs on disk scaled as they're read back; null words may be counted there, so kept
+			spill_runs_scale(*(csv_data_get_column_to_runs(info) + i), factor);
+			continue;
+		}
+		// Null words that aren't counted anymore have aged out as well
+		hashtable_filter(*(csv_data_get_column_to_nulls(info) + i), &job, still_counted);
+	}
+	csv_data_set_rows_weight(info, csv_data_get_rows_weight(info) * factor);
+	if (min_count < csv_data_get_min_count(info)) {
+		csv_data_set_min_count(info, min_count);
+	}
+	return 0;
+}
+
+int nullfinder_merge(nullfinder_t *dst, nullfinder_t *src)
+{
+	if (dst == NULL || src == NULL || dst == src || dst->finalized || src->finalized) {
+		return 2;
+	}
+
+	// Flush out src's last row, nothing more goes into it after this
+	if (!src->resync) {
+		csv_fini(&src->parser, on_field_read, on_row_read, src);
+	}
+	src->finalized = true;
+	dst->bad_rows_n += src->bad_rows_n;
+	dst->parse_errors_n += src->parse_errors_n;
+	dst->skipped_n += src->skipped_n;
+
+	int cols_n = csv_data_get_cols_n(src->info);
+	if (cols_n == 0) { // Nothing in it
+		return 0;
+	}
+	if (dst->width == 0) {
+		dst->width = src->width;
+	}
+	if (csv_data_get_cols_n(dst->info) < cols_n) { // src saw wider rows than dst did, so make room
+		int stat = setup_columns(dst->info, cols_n);
+		if (stat != 0) {
+			return stat;
+		}
+	}
+
+	for (int i = 0; i < cols_n; i++) {
+		move_job_t job = {*(csv_data_get_columns(dst->info) + i), *(csv_data_get_typed(dst->info) + i), *(csv_data_get_candidates(dst->info) + i), 0};
+		hashtable_iterate(*(csv_data_get_columns(src->info) + i), &job, merge_count);
+		typed_column_iterate(*(csv_data_get_typed(src->info) + i), &job, merge_count);
+		hashtable_iterate(*(csv_data_get_column_to_nulls(src->info) + i), *(csv_data_get_column_to_nulls(dst->info) + i), merge_null);
+		if (is_spilled(src->info, i)) { // Runs just change hands
+			spill_runs_t **runs = csv_data_get_column_to_runs(dst->info);
+			if (runs == NULL && (runs = csv_data_new_column_to_runs(dst->info)) == NULL) {
+				return 4;
+			}
+			if (runs[i] == NULL && (runs[i] = spill_runs_new()) == NULL) {
+				return 4;
+			}
+			if (spill_runs_adopt(runs[i], *(csv_data_get_column_to_runs(src->info) + i)) != 0) {
+				return 4;
+			}
+		}
+	}
+	if (dst->memory_limit > 0 && check_memory(dst) != 0) {
+		return 4;
+	}
+	csv_data_set_rows_read(dst->info, csv_data_get_rows_read(dst->info) + csv_data_get_rows_read(src->info));
+	csv_data_set_rows_weight(dst->info, csv_data_get_rows_weight(dst->info) + csv_data_get_rows_weight(src->info));
+	return 0;
+}
+
+int nullfinder_get_cols_n(nullfinder_t *nf)
+{
+	if (nf != NULL) {return csv_data_get_cols_n(nf->info);}
+	return -1;
+}
+
+int nullfinder_get_rows_read(nullfinder_t *nf)
+{
+	if (nf != NULL) {return csv_data_get_rows_read(nf->info);}
+	return -1;
+}
+
+int nullfinder_get_bad_rows(nullfinder_t *nf)
+{
+	if (nf != NULL) {return nf->bad_rows_n;}
+	return -1;
+}
+
+int nullfinder_get_parse_errors(nullfinder_t *nf)
+{
+	if (nf != NULL) {return nf->parse_errors_n;}
+	return -1;
+}
+
+long nullfinder_get_skipped(nullfinder_t *nf)
+{
+	if (nf != NULL) {return nf->skipped_n;}
+	return -1;
+}
+
+bool nullfinder_mid_row(nullfinder_t *nf)
+{
+	// Parser's back in its 1st state (libcsv's ROW_NOT_BEGUN, 0) only once a row's ended
+	if (nf != NULL) {return nf->resync || nf->parser.pstate != 0;}
+	return false;
+}
+
+int nullfinder_iterate(nullfinder_t *nf, int col, void *data, void (*func)(void *data, const char *word))
+{
+	if (nf == NULL || func == NULL || !nf->evaluated || col < 0 || col >= csv_data_get_cols_n(nf->info)) {
+		return 2;
+	}
+
+	// Both kinds of null words, in sorted order so results don't depend on table sizes
+	result_job_t job = {data, func};
+	results_iterate(*(csv_data_get_column_to_results(nf->info) + col), &job, pass_result);
+	return 0;
+}
+
+const results_t *nullfinder_get_results(nullfinder_t *nf, int col)
+{
+	if (nf == NULL || !nf->evaluated || col < 0 || col >= csv_data_get_cols_n(nf->info)) {
+		return NULL;
+	}
+	return *(csv_data_get_column_to_results(nf->info) + col);
+}
+
+void nullfinder_free(nullfinder_t *nf)
+{
+	if (nf != NULL) {
+		csv_free(&nf->parser);
+		csv_data_free(nf->info);
+		spill_file_free(nf->spill); // Closed once runs in it are freed too
+		free(nf->row);
+		free(nf->field_ends);
+		free(nf->conv);
+		matcher_free(nf->own_nulls);
+		free(nf);
+	}
+}
+
+/* Adds a word's freq into another column's tables, in an iterate function
+ * Goes into typed column if it fits there, otherwise string table
+ * @param data move_job_t ptr, tables to add into
+ * @param key word
+ * @param val word's freq
+ */
+static void merge_count(void *data, const char *key, void *val)
+{
+	if (data != NULL && key != NULL && val != NULL) {
+		move_job_t *job = (move_job_t *)data;
+		hashtable_t *column = job->column;
+		float *count;
+
+		if (typed_column_add(job->typed, key, strlen(key), *(float *)val)) {
+			return;
+		}
+		if ((count = hashtable_find(column, key)) != NULL) {
+			*count += *(float *)val;
+		}
+		else if ((count = malloc(sizeof(float))) != NULL) {
+			*count = *(float *)val;
+			if (hashtable_insert(column, key, count) != 0) {
+				fprintf(stderr, "Malloc error for columns\n");
+				free(count);
+				job->stat = 4;
+			}
+			else {
+				index_candidate(job->cands, key, count);
+			}
+		}
+	}
+}
+
+/* Adds a null word into column_to_nulls table of another analyzer, in an iterate function
+ * @param data hashtable_t ptr, column_to_nulls table to add into
+ * @param key null word
+ * @param val dummy item
+ */
+static void merge_null(void *data, const char *key, void *val)
+{
+	if (data != NULL && key != NULL) {
+		hashtable_t *column_nulls = (hashtable_t *)data;
+		char *dummy = malloc(sizeof(char));
+
+		if (dummy == NULL || hashtable_insert(column_nulls, key, dummy) != 0) { // Already there
+			free(dummy);
+		}
+	}
+}
+
+/* Sets up columns & column_to_nulls tables for every column not set up yet; all initially empty
+ * Called once header's read, & again whenever a row turns up w/ more cols than seen so far
+ * @param info csv_data_t to add columns to
+ * @param cols_n # columns wanted in total
+ * @return exit status
+ */
+static int setup_columns(csv_data_t *info, int cols_n)
+{
+	int old_n = csv_data_get_cols_n(info);
+	// Tables sized for rows # if we know it, otherwise start small & let them grow
+	int slots_n = (csv_data_get_rows_n(info) > 0) ? csv_data_get_rows_n(info) * 2 : DEFAULT_SLOTS;
+
+	if (csv_data_grow_cols_n(info, cols_n) != cols_n) { // Set total col number in csv info struct
+		fprintf(stderr, "Malloc error\n");
+		return 4;
+	}
+
+	for (int i = old_n; i < cols_n; i++) {
+		if ((*(csv_data_get_columns(info)+i) = hashtable_new(slots_n)) == NULL) {
+			fprintf(stderr, "Malloc error for columns\n");
+			return 4;
+		}
+		if ((*(csv_data_get_typed(info)+i) = typed_column_new()) == NULL) {
+			fprintf(stderr, "Malloc error for typed columns\n");
+			return 4;
+		}
+		if (csv_data_get_rows_read(info) >= TYPE_SAMPLE) { // Too late to sample this col, so it's just strings
+			typed_column_decide(*(csv_data_get_typed(info)+i), false);
+		}
+		if ((*(csv_data_get_candidates(info)+i) = candidates_new()) == NULL) {
+			fprintf(stderr, "Malloc error for candidates\n");
+			return 4;
+		}
+		if ((*(csv_data_get_column_to_nulls(info)+i) = hashtable_new(slots_n)) == NULL) {
+			fprintf(stderr, "Malloc error for column_to_nulls\n");
+			return 4;
+		}
+	}
+	return 0;
+}
+
+/* Hands a single null word over to user's func, in a results iterate function
+ * @param data result_job_t ptr
+ * @param word the null word
+ * @param count word's freq, not passed on
+ */
+static void pass_result(void *data, const char *word, float count)
+{
+	if (data != NULL && word != NULL) {
+		result_job_t *job = (result_job_t *)data;
+		(*job->func)(job->data, word);
+	}
+}
+
+/* Works out null words from everything fed in so far; can be done any # of times
+ * @param nf analyzer
+ * @return exit status
+ */
+static int evaluate(nullfinder_t *nf)
+{
+	csv_data_t *info = nf->info;
+
+	nf->evaluated = true;
+	if (csv_data_get_cols_n(info) == 0) {
+		return 0;
+	}
+
+	// Make room for avg probability w/ which words occur in each col, & words found by rarity; filled in per col below
+	if (csv_data_avg_probabilities_new(info) == NULL || csv_data_get_columns(info) == NULL || csv_data_get_column_to_nulls(info) == NULL) {
+		return 4;
+	}
+	if (csv_data_get_column_to_rare(info) == NULL && csv_data_new_column_to_rare(info) == NULL) {
+		return 4;
+	}
+	if (csv_data_get_column_to_results(info) == NULL && csv_data_new_column_to_results(info) == NULL) {
+		return 4;
+	}
+	// Spilled cols are worked out from their runs alone, so whatever's left in memory goes out as 1 more run
+	// (done here since only 1 thread can write to spill file)
+	for (int i = 0; i < csv_data_get_cols_n(info); i++) {
+		if (is_spilled(info, i) && spill_column(nf, i) != 0) {
+			fprintf(stderr, "Error spilling columns to disk\n");
+			return 4;
+		}
+	}
+
+	// For every col, divide freq of a unique word by total rows to get probability,
+	// then put any null words detected by probability in column_to_rare
+	// Cols are independent of each other so spread them across threads
+	return workpool_run(csv_data_get_cols_n(info), nf->threads_n, info, finalize_column);
+}
+
+/* Scales down a word's freq, in a filter function
+ * @param data decay_job_t ptr
+ * @param key word
+ * @param val word's freq
+ * @return false if freq now too low to keep word
+ */
+static bool decay_count(void *data, const char *key, void *val)
+{
+	decay_job_t *job = (decay_job_t *)data;
+	float *count = (float *)val;
+
+	*count *= job->factor;
+	return *count >= job->min_count;
+}
+
+/* Whether a null word is still counted in its column, in a filter function
+ * @param data decay_job_t ptr
+ * @param key null word (<empty> for empty field)
+ * @param val dummy item
+ * @return true if word still in column table
+ */
+static bool still_counted(void *data, const char *key, void *val)
+{
+	decay_job_t *job = (decay_job_t *)data;
+
+	if (strcmp(key, "<empty>") == 0) {
+		return hashtable_find(job->column, "") != NULL || hashtable_find(job->column, key) != NULL;
+	}
+	return hashtable_find(job->column, key) != NULL;
+}
+
+/* Works out null words for a single col: ones by rarity, then every null word sorted into col's results
+ * Spilled cols are worked out from their runs instead
+ * Run by workpool_run, possibly at same time as other cols
+ * @param data csv_data_t ptr
+ * @param col index of col to finish
+ */
+static void finalize_column(void *data, int col)
+{
+	csv_data_t *info = (csv_data_t *)data;
+
+	if (is_spilled(info, col)) {
+		finalize_spilled(info, col);
+		return;
+	}
+	find_rare(info, col);
+	collect_results(info, col);
+}
+
+/* Works out null words by rarity for a single col: avg probability, word probabilities, nulls by probability
+ * @param info csv_data_t w/ col's tables
+ * @param col index of col
+ */
+static void find_rare(csv_data_t *info, int col)
+{
+	typed_column_t *typed = *(csv_data_get_typed(info) + col);
+	hashtable_t **column_rare = csv_data_get_column_to_rare(info) + col;
+	// Rows # given up front if any, otherwise what we actually saw
+	float rows = (csv_data_get_rows_n(info) > 0) ? (float)csv_data_get_rows_n(info) : (float)csv_data_get_rows_weight(info);
+	col_job_t job = {info, col, rows};
+	float *avg;
+
+	// Start over on words found by rarity
+	hashtable_free(*column_rare);
+	if ((*column_rare = hashtable_new(RARE_SLOTS)) == NULL) {
+		fprintf(stderr, "Malloc error for column_to_rare\n");
+		return;
+	}
+
+	if ((avg = csv_data_avg_probability_new(info, col)) == NULL) {
+		fprintf(stderr, "Malloc error for avg probability\n");
+		return;
+	}
+	if (!is_rare(csv_data_get_min_count(info) / job.rows, *avg)) { // Not even a word seen once is rare enough in this col
+		return;
+	}
+
+	// Only short values can be null words by rarity, & those are all indexed already
+	candidates_iterate(*(csv_data_get_candidates(info) + col), &job, find_nulls_by_probabilities);
+	// Typed values aren't indexed, but only ones w/ low freq get looked at (w/ a bit of slack for float rounding)
+	typed_column_iterate_rare(typed, (float)(*avg * 0.02 * job.rows) * 1.01f + 0.01f, &job, find_nulls_by_probabilities);
+}
+
+/* Gathers every null word found in a col w/ its freq into col's results, sorted
+ * Pre-defined null words first, then ones found by rarity that aren't among those; sorting puts them all in order anyway
+ * @param info csv_data_t w/ col's tables
+ * @param col index of col
+ */
+static void collect_results(csv_data_t *info, int col)
+{
+	results_t **results = csv_data_get_column_to_results(info) + col;
+	hashtable_t *column_nulls = *(csv_data_get_column_to_nulls(info) + col);
+
+	results_free(*results);
+	if ((*results = results_new()) == NULL) {
+		fprintf(stderr, "Malloc error for results\n");
+		return;
+	}
+	collect_job_t job = {*results, *(csv_data_get_columns(info) + col), *(csv_data_get_typed(info) + col), NULL, 0};
+	hashtable_iterate(column_nulls, &job, collect_result);
+	job.skip = column_nulls;
+	hashtable_iterate(*(csv_data_get_column_to_rare(info) + col), &job, collect_result);
+	if (job.stat != 0 || results_sort(*results) != 0) {
+		fprintf(stderr, "Malloc error for results\n");
+	}
+}
+
+/* Adds a single null word w/ its freq to a col's results, in an iterate function
+ * @param data collect_job_t ptr
+ * @param key the null word (<empty> for empty field)
+ * @param val dummy item, freq's looked up in col's tables
+ */
+static void collect_result(void *data, const char *key, void *val)
+{
+	collect_job_t *job = (collect_job_t *)data;
+	float count = 0;
+	float *found;
+
+	if (job->skip != NULL && hashtable_find(job->skip, key) != NULL) {
+		return;
+	}
+	if (strcmp(key, "<empty>") == 0 && (found = hashtable_find(job->column, "")) != NULL) {
+		count += *found;
+	}
+	if ((found = hashtable_find(job->column, key)) != NULL) {
+		count += *found;
+	}
+	else {
+		count += typed_column_get_count(job->typed, key, strlen(key));
+	}
+	if (results_add(job->results, key, count) != 0) {
+		job->stat = 4;
+	}
+}
+
+/* Whether a word's probability is low enough compared to avg probability in its col to be a null word
+ * @param prob word's probability
+ * @param avg avg probability of words in col
+ * @return true if rare enough
+ */
+static bool is_rare(float prob, float avg)
+{
+	return (avg < 0.5 && prob <= avg * 0.02) || (avg >= 0.5 && prob < avg * 0.02);
+}
+
+/* Whether a word is short enough (in terms of length & word #) to ever be a null word by rarity
+ * @param key word
+ * @return true if short enough
+ */
+static bool is_candidate(const char *key)
+{
+	size_t len = strlen(key);
+	return len < CANDIDATE_LEN && utf8_word_count(key, len) <= 3;
+}
+
+/* Adds a word to candidates index if short enough, in an iterate function
+ * @param data candidates_t ptr
+ * @param key word
+ * @param val word's freq, owned by column table
+ */
+static void index_candidate(void *data, const char *key, void *val)
+{
+	if (data != NULL && key != NULL && val != NULL && is_candidate(key)) {
+		candidates_add((candidates_t *)data, key, (float *)val);
+	}
+}
+
+/* Detects null words, determined as words w/ low enough probabilities of showing up in that col
+ * then adds words to column_to_nulls
+ * @param data col_job_t ptr, holding csv_data_t w/ the 2 important hashtable arrays & which col we're in
+ * @param key current word we're determining whether null
+ * @val word's freq
+ */
+static void find_nulls_by_probabilities(void *data, const char *key, void *val)
+{
+	if (data != NULL && key != NULL && val != NULL) {
+		col_job_t *job = (col_job_t *)data;
+		hashtable_t *column_nulls = *(csv_data_get_column_to_rare(job->info) + job->col);
+		float *avg = *(csv_data_get_avg_probabilities(job->info) + job->col);
+		float prob = *(float *)val / job->rows; // Freqs left as is, so can be looked at again
+		
+		// Probability sufficiently less than avg probability in col, and word isn't too long in terms of length & word #
+		if (is_rare(prob, *avg) && is_candidate(key))  {
+			char *dummy = malloc(sizeof(char)); // Dummy value item for inserting new null word detected
+			if (hashtable_insert(column_nulls, key, dummy) != 0) { // Clean up if can't insert
+				free(dummy);
+			}
+		}
+	}
+}
+
+/* Callback function every time we finish reading a field
+ * Counted right away, unless rows w/ wrong # fields are left out; then held until whole row's read
+ * @param s field string
+ * @param len length of field string
+ * @data nullfinder_t* ptr, analyzer being fed
+ */
+static void on_field_read(void *s, size_t len, void *data)
+{
+	nullfinder_t *nf = (nullfinder_t *)data;
+
+	if (nf->bad_rows == BAD_ROWS_COUNT && !nf->prefetch) {
+		count_field(nf, (char *)s, len);
+		return;
+	}
+
+	// Hold onto field til we know row's ok
+	if (nf->row_len + len > nf->row_cap) {
+		size_t cap = (nf->row_cap == 0) ? 256 : nf->row_cap;
+		while (cap < nf->row_len + len) {
+			cap *= 2;
+		}
+		char *grown = realloc(nf->row, cap);
+		if (grown == NULL) {
+			fprintf(stderr, "Malloc error for row\n");
+			return;
+		}
+		nf->row = grown;
+		nf->row_cap = cap;
+	}
+	if (nf->fields_n == nf->fields_cap) {
+		int cap = (nf->fields_cap == 0) ? 16 : nf->fields_cap * 2;
+		size_t *grown = realloc(nf->field_ends, cap * sizeof(size_t));
+		if (grown == NULL) {
+			fprintf(stderr, "Malloc error for row\n");
+			return;
+		}
+		nf->field_ends = grown;
+		nf->fields_cap = cap;
+	}
+	memcpy(nf->row + nf->row_len, s, len);
+	nf->row_len += len;
+	nf->field_ends[nf->fields_n++] = nf->row_len;
+}
+
+/* Counts a single field in its column
+ * @param nf analyzer
+ * @param s field string
+ * @param len length of field string
+ */
+static void count_field(nullfinder_t *nf, char *s, size_t len)
+{
+	csv_data_t *info = nf->info;
+	csv_data_set_col_curr(info, csv_data_get_col_curr(info)+1); // For reference later, we know which column we're on
+	
+	if (csv_data_get_cols_n(info) == 0) {return;} // The rest is for 2nd+ rows
+	if (csv_data_get_col_curr(info) > csv_data_get_cols_n(info)) { // Row wider than any so far, make room
+		if (setup_columns(info, csv_data_get_col_curr(info)) != 0) {
+			return;
+		}
+	}
+	if (nf->encoding != ENCODING_UTF8 && (s = to_utf8(nf, s, &len)) == NULL) {
+		return;
+	}
+	
+	// Numeric/date cols: cells that fit are just counted in typed column, no string copies or null word checks
+	typed_column_t *typed = *(csv_data_get_typed(info)+csv_data_get_col_curr(info)-1);
+	if (typed_column_get_type(typed) == TYPE_SAMPLING) {
+		typed_column_sample(typed, (char *)s, len);
+	}
+	else if (typed_column_add(typed, (char *)s, len, 1)) {
+		return;
+	}
+	
+	char *s_char = (char *)s; // For rebuilding s
+	char *field = calloc((len+1), sizeof(char)); // s isn't completely sanitized, so just rebuild our own s
+	int len_so_far = 0; // For rebuilding s
+	matcher_t *null_words; // Get from csv info
+	hashtable_t **column_to_nulls; // Get from csv info
+	hashtable_t **columns; // Get from csv info
+	
+	// Build s as field
+	while (len) {
+		len_so_far = strlen(field);
+		*(field+len_so_far) = *(s_char);
+		*(field+len_so_far+1) = '\0';
+		s_char++;
+		len--;
+	}
+	
+	null_words = csv_data_get_nulls(info);
+	column_to_nulls = csv_data_get_column_to_nulls(info);
+	columns = csv_data_get_columns(info);
+	
+	/* Insert into columns */
+	float *count = malloc(sizeof(int)); // Item which we insert in, if never seen word before
+	*count = 1;
+	int stat = 0; // Track status see if successful insert
+	if ((stat = hashtable_insert(*(columns+csv_data_get_col_curr(info)-1), field, count)) == 0) { // New item
+		index_candidate(*(csv_data_get_candidates(info)+csv_data_get_col_curr(info)-1), field, count);
+	}
+	else if (stat == 3) { // Repeated item
+		free(count);
+		count = NULL;
+		count = (hashtable_find(*(columns+csv_data_get_col_curr(info)-1), field));
+		if (count != NULL) {
+			++*(count); // Increment existing freq
+		}
+	}
+	else if (stat == 4) { // Some malloc error, just clean up
+		free(count);
+	}
+	
+	char *field_lc = calloc(strlen(field)+1, sizeof(char));
+	size_t lc_len = utf8_fold(field, strlen(field), field_lc); // Case folded, so "NÃO INFORMADO" matches "não informado"
+	/* Insert into column_to_nulls */
+	// Some null word is substring of field, word is short enough (word # and string length) absolutely & relatively compared to null word
+	// Longest null word found is the one that gives field the best chance relatively
+	// Fields longer than usual only qualify if they're a whole null word (e.g. "não informado")
+	size_t longest = (lc_len < 10 || lc_len <= matcher_get_max_len(null_words)) ? matcher_longest(null_words, field_lc, lc_len) : 0;
+	bool qualifies = (lc_len < 10) ? (longest > 0 && lc_len < (longest * 2)) : (longest == lc_len);
+	if (qualifies && utf8_word_count(field_lc, lc_len) <= 3) {
+		char *dummy = malloc(sizeof(char));
+		
+		if (hashtable_insert(*(column_to_nulls+csv_data_get_col_curr(info)-1), field, dummy) == 0) {
+			free(field_lc);
+			free(field);
+			return;
+		}
+		else { // Clean up if unsuccessful
+			free(dummy);
+		}
+	}
+
+	// Alternatively, if field is empty, this may be considered null, represented by <empty>
+	if (strlen(field) == 0) {
+		char *dummy = malloc(sizeof(char));
+		if (hashtable_insert(*(column_to_nulls+csv_data_get_col_curr(info)-1), "<empty>", dummy) != 0) {
+			free(dummy);
+		}
+	}
+	free(field_lc);
+	free(field);
+}
+
+/* Callback function every time we finish reading a row
+ * @param c current char processed by csvlib
+ * @param data nullfinder_t*, analyzer being fed
+ */
+static void on_row_read(int c, void *data)
+{ 
+	nullfinder_t *nf = (nullfinder_t *)data;
+
+	if (nf->bad_rows != BAD_ROWS_COUNT || nf->prefetch) { // Whole row held, so can still leave it out
+		if (nf->bad_rows != BAD_ROWS_COUNT && nf->width != 0 && nf->fields_n != nf->width) {
+			reject_row(nf, true);
+			return;
+		}
+		count_row(nf);
+	}
+	end_row(nf);
+}
+
+/* Counts every field of row held so far, loading column slots of fields a few ahead (if prefetching)
+ * so their cache misses overlap w/ counting the ones before
+ * @param nf analyzer
+ */
+static void count_row(nullfinder_t *nf)
+{
+	csv_data_t *info = nf->info;
+	int first = csv_data_get_col_curr(info); // Index of 1st held field's col
+	bool prefetch = nf->prefetch && nf->encoding == ENCODING_UTF8; // Otherwise fields are converted before lookup
+	size_t start = 0;
+
+	for (int i = 0; i < nf->fields_n + PREFETCH_AHEAD; i++) {
+		// Typed cols count fields that fit w/o touching string table, so its slot isn't worth hashing for
+		if (prefetch && i < nf->fields_n && first + i < csv_data_get_cols_n(info) && !is_typed(info, first + i)) {
+			size_t ahead_start = (i > 0) ? nf->field_ends[i-1] : 0;
+			hashtable_prefetch(*(csv_data_get_columns(info) + first + i), nf->row + ahead_start, nf->field_ends[i] - ahead_start);
+		}
+		int k = i - PREFETCH_AHEAD; // Field whose slot was asked for a few fields ago
+		if (k >= 0) {
+			count_field(nf, nf->row + start, nf->field_ends[k] - start);
+			start = nf->field_ends[k];
+		}
+	}
+	nf->row_len = 0;
+	nf->fields_n = 0;
+}
+
+/* Whether a col's been decided to be typed (number or date), so fields that fit never go to its string table
+ * @param info csv_data_t w/ col's tables
+ * @param col index of col
+ * @return true if col is typed
+ */
+static bool is_typed(csv_data_t *info, int col)
+{
+	column_type_t type = typed_column_get_type(*(csv_data_get_typed(info) + col));
+	return type == TYPE_NUMBER || type == TYPE_DATE;
+}
+
+/* Finishes off a row whose fields have all been counted
+ * @param nf analyzer
+ */
+static void end_row(nullfinder_t *nf)
+{
+	csv_data_t *info = nf->info;
+
+	if (nf->width != 0 && csv_data_get_col_curr(info) != nf->width) { // Counted anyway, but let user know
+		nf->bad_rows_n++;
+	}
+	if (csv_data_get_cols_n(info) != 0) {
+		int rows_read = csv_data_inc_rows_read(info);
+		if (rows_read == TYPE_SAMPLE) { // Seen enough to guess col types
+			decide_types(info);
+		}
+		if (nf->memory_limit > 0 && rows_read % MEMORY_CHECK_ROWS == 0 && check_memory(nf) != 0) {
+			fprintf(stderr, "Error spilling columns to disk\n");
+		}
+	}
+	else { // Only true after read first row
+		nf->width = csv_data_get_col_curr(info);
+		setup_columns(info, nf->width);
+	}
+	csv_data_set_col_curr(info, 0); // Reset current column processing to 0 every time finish a row
+}
+
+/* Leaves out row held so far (wrong # fields, or parser gave up on it), writing it to quarantine file if any
+ * @param nf analyzer
+ * @param whole false if parser gave up partway through row, so rest of line's still to be quarantined after it
+ */
+static void reject_row(nullfinder_t *nf, bool whole)
+{
+	if (nf->quarantine != NULL) { // Written back out as csv, whole row at once since file may be shared
+		size_t start = 0;
+
+		flockfile(nf->quarantine);
+		for (int i = 0; i < nf->fields_n; i++) {
+			if (i > 0) {
+				fputc(csv_get_delim(&nf->parser), nf->quarantine);
+			}
+			csv_fwrite(nf->quarantine, nf->row + start, nf->field_ends[i] - start);
+			start = nf->field_ends[i];
+		}
+		fputc(whole ? '\n' : csv_get_delim(&nf->parser), nf->quarantine);
+		funlockfile(nf->quarantine);
+	}
+	nf->bad_rows_n++;
+	nf->row_len = 0;
+	nf->fields_n = 0;
+}
+
+/* Skips up to & incl. next newline after parser's given up, writing what's skipped to quarantine file if any
+ * Caller holds lock on quarantine file
+ * @param nf analyzer
+ * @param buf rest of bytes fed in
+ * @param len # bytes in buf
+ * @return # bytes skipped; if no newline, all of them & skipping goes on in next buffer
+ */
+static size_t skip_line(nullfinder_t *nf, const char *buf, size_t len)
+{
+	const char *nl = memchr(buf, '\n', len);
+	size_t skip = (nl != NULL) ? (size_t)(nl - buf) + 1 : len;
+
+	if (nf->quarantine != NULL) {
+		fwrite(buf, sizeof(char), skip, nf->quarantine);
+	}
+	nf->skipped_n += skip;
+	nf->resync = (nl == NULL);
+	return skip;
+}
+
+/* Converts Latin-1 field to UTF-8, so same word counts the same whatever file's encoding
+ * @param nf analyzer, holds buffer for converted field
+ * @param s field
+ * @param len field's length, updated to converted length
+ * @return s itself if plain ASCII, otherwise converted field (valid til next call), NULL if malloc error
+ */
+static char *to_utf8(nullfinder_t *nf, char *s, size_t *len)
+{
+	size_t high = 0; // Bytes that need 2 in UTF-8
+
+	for (size_t i = 0; i < *len; i++) {
+		high += ((unsigned char)s[i] >= 0x80);
+	}
+	if (high == 0) {
+		return s;
+	}
+
+	if (*len + high > nf->conv_cap) {
+		char *grown = realloc(nf->conv, *len + high);
+		if (grown == NULL) {
+			fprintf(stderr, "Malloc error for field\n");
+			return NULL;
+		}
+		nf->conv = grown;
+		nf->conv_cap = *len + high;
+	}
+	size_t j = 0;
+	for (size_t i = 0; i < *len; i++) {
+		unsigned char c = (unsigned char)s[i];
+		if (c < 0x80) {
+			nf->conv[j++] = (char)c;
+		}
+		else {
+			nf->conv[j++] = (char)(0xC0 | (c >> 6));
+			nf->conv[j++] = (char)(0x80 | (c & 0x3F));
+		}
+	}
+	*len = j;
+	return nf->conv;
+}
+
+/* Starts parser over after it's given up, w/ same options
+ * @param nf analyzer
+ * @return exit status
+ */
+static int reset_parser(nullfinder_t *nf)
+{
+	unsigned char opts = csv_get_opts(&nf->parser);
+	unsigned char delim = csv_get_delim(&nf->parser);
+	unsigned char quote = csv_get_quote(&nf->parser);
+
+	csv_free(&nf->parser);
+	if (csv_init(&nf->parser, opts) != 0) {
+		return 4;
+	}
+	csv_set_delim(&nf->parser, delim);
+	csv_set_quote(&nf->parser, quote);
+	return 0;
+}
+
+/* Decides type of every col from rows sampled so far; for cols that turn out typed,
+ * moves values that fit out of string table into typed column
+ * @param info csv_data_t w/ cols still sampling
+ */
+static void decide_types(csv_data_t *info)
+{
+	// Typed cells skip null word checks, so can't type cols if a typed cell could be a null word
+	bool allowed = !matcher_has_word_of(csv_data_get_nulls(info), TYPED_CHARS);
+
+	for (int i = 0; i < csv_data_get_cols_n(info); i++) {
+		typed_column_t *typed = *(csv_data_get_typed(info)+i);
+		candidates_t *cands = *(csv_data_get_candidates(info)+i);
+		hashtable_t *column = *(csv_data_get_columns(info)+i);
+
+		if (typed_column_decide(typed, allowed) != TYPE_STRING) {
+			move_job_t job = {hashtable_new(DEFAULT_SLOTS), typed, cands, 0};
+			candidates_clear(cands); // Points into old table, re-indexed as values move into new one
+			if (job.column != NULL) {
+				hashtable_iterate(column, &job, merge_count);
+			}
+			if (job.column == NULL || job.stat != 0) { // Leave col as it was, untyped, so no value ends up in both
+				fprintf(stderr, "Malloc error for columns\n");
+				hashtable_free(job.column);
+				typed_column_abandon(typed);
+				candidates_clear(cands);
+				hashtable_iterate(column, cands, index_candidate);
+				continue;
+			}
+			hashtable_free(column);
+			*(csv_data_get_columns(info)+i) = job.column;
+		}
+	}
+}
+
+/* Estimates how much memory a col's tables take up (the ones that get spilled)
+ * @param info csv_data_t w/ col's tables
+ * @param col index of col
+ * @return # bytes
+ */
+static size_t column_size(csv_data_t *info, int col)
+{
+	hashtable_t *column = *(csv_data_get_columns(info) + col);
+
+	return hashtable_get_size(column) + (size_t)hashtable_get_items_n(column) * COUNT_BYTES
+		+ typed_column_get_size(*(csv_data_get_typed(info) + col)) + candidates_get_size(*(csv_data_get_candidates(info) + col));
+}
+
+/* Whether any of a col's freqs have been spilled to disk
+ * @param info csv_data_t w/ col's tables
+ * @param col index of col
+ * @return true if col has runs
+ */
+static bool is_spilled(csv_data_t *info, int col)
+{
+	spill_runs_t **runs = csv_data_get_column_to_runs(info);
+	return runs != NULL && spill_runs_get_n(runs[col]) > 0;
+}
+
+/* If col tables take up more than memory limit, spills biggest cols til they're down to half of it,
+ * so it's a while before next spill
+ * @param nf analyzer w/ memory limit
+ * @return exit status
+ */
+static int check_memory(nullfinder_t *nf)
+{
+	int cols_n = csv_data_get_cols_n(nf->info);
+	size_t total = 0;
+	size_t *sizes;
+	int stat = 0;
+
+	if (cols_n <= 0) {
+		return 0;
+	}
+	if ((sizes = malloc(cols_n * sizeof(size_t))) == NULL) {
+		return 4;
+	}
+	for (int i = 0; i < cols_n; i++) {
+		sizes[i] = column_size(nf->info, i);
+		total += sizes[i];
+	}
+	if (total > nf->memory_limit) {
+		while (stat == 0 && total > nf->memory_limit / 2) {
+			int biggest = 0;
+			for (int i = 1; i < cols_n; i++) {
+				if (sizes[i] > sizes[biggest]) {
+					biggest = i;
+				}
+			}
+			if (sizes[biggest] == 0) { // Every col spilled already
+				break;
+			}
+			stat = spill_column(nf, biggest);
+			total -= sizes[biggest];
+			sizes[biggest] = 0;
+		}
+	}
+	free(sizes);
+	return stat;
+}
+
+/* Writes every word & freq counted in a col out to disk as a sorted run, then starts col's tables over empty
+ * Null words found in col so far stay in memory, they're looked up when col's finished
+ * @param nf analyzer
+ * @param col index of col
+ * @return exit status (col left as it was if not 0)
+ */
+static int spill_column(nullfinder_t *nf, int col)
+{
+	csv_data_t *info = nf->info;
+	hashtable_t **column = csv_data_get_columns(info) + col;
+	typed_column_t *typed = *(csv_data_get_typed(info) + col);
+	candidates_t **cands = csv_data_get_candidates(info) + col;
+	int typed_n = typed_column_get_keys_n(typed);
+	int items_n = hashtable_get_items_n(*column) + typed_n;
+	spill_runs_t **runs;
+	gather_job_t job = {NULL, 0, NULL, 0};
+	hashtable_t *fresh;
+	candidates_t *fresh_cands;
+	int stat;
+
+	if (items_n == 0) {
+		return 0;
+	}
+	if (nf->spill == NULL && (nf->spill = spill_file_new()) == NULL) {
+		return 4;
+	}
+	if ((runs = csv_data_get_column_to_runs(info)) == NULL && (runs = csv_data_new_column_to_runs(info)) == NULL) {
+		return 4;
+	}
+	if (runs[col] == NULL && (runs[col] = spill_runs_new()) == NULL) {
+		return 4;
+	}
+
+	// Made up front so nothing can fail once col's on disk
+	job.items = malloc(items_n * sizeof(spill_item_t));
+	job.copies = malloc((typed_n > 0 ? typed_n : 1) * sizeof(*job.copies));
+	fresh = hashtable_new(DEFAULT_SLOTS);
+	fresh_cands = candidates_new();
+	if (job.items == NULL || job.copies == NULL || fresh == NULL || fresh_cands == NULL) {
+		free(job.items);
+		free(job.copies);
+		hashtable_free(fresh);
+		candidates_free(fresh_cands);
+		return 4;
+	}
+	hashtable_iterate(*column, &job, gather_item);
+	typed_column_iterate(typed, &job, gather_typed);
+	stat = spill_runs_write(runs[col], nf->spill, job.items, job.items_n);
+	free(job.items);
+	free(job.copies);
+	if (stat != 0) {
+		hashtable_free(fresh);
+		candidates_free(fresh_cands);
+		return stat;
+	}
+
+	hashtable_free(*column);
+	*column = fresh;
+	candidates_free(*cands);
+	*cands = fresh_cands;
+	typed_column_clear(typed); // If it can't, col's values just go to string table from now on
+	return 0;
+}
+
+/* Adds a word & its freq to words to spill, in an iterate function; word's left where it is til spilled
+ * @param data gather_job_t ptr
+ * @param key word
+ * @param val word's freq
+ */
+static void gather_item(void *data, const char *key, void *val)
+{
+	gather_job_t *job = (gather_job_t *)data;
+
+	job->items[job->items_n].key = key;
+	job->items[job->items_n].count = *(float *)val;
+	job->items_n++;
+}
+
+/* Adds a typed value & its freq to words to spill, in an iterate function; value's printed back into a temp buffer, so copied
+ * @param data gather_job_t ptr
+ * @param key value printed back
+ * @param val value's freq
+ */
+static void gather_typed(void *data, const char *key, void *val)
+{
+	gather_job_t *job = (gather_job_t *)data;
+
+	strcpy(job->copies[job->copies_n], key);
+	gather_item(data, job->copies[job->copies_n++], val);
+}
+
+/* Works out null words for a spilled col from its runs: 1st pass counts unique words for avg probability,
+ * 2nd looks up every word's exact freq, same tests as find_rare & collect_results
+ * @param info csv_data_t w/ col's tables, everything counted in col's already in runs
+ * @param col index of col
+ */
+static void finalize_spilled(csv_data_t *info, int col)
+{
+	spill_runs_t *runs = *(csv_data_get_column_to_runs(info) + col);
+	hashtable_t **column_rare = csv_data_get_column_to_rare(info) + col;
+	results_t **results = csv_data_get_column_to_results(info) + col;
+	merged_job_t job = {info, col, 0, 0, false, 0, NULL, 0};
+	float *avg;
+
+	job.rows = (csv_data_get_rows_n(info) > 0) ? (float)csv_data_get_rows_n(info) : (float)csv_data_get_rows_weight(info);
+	hashtable_free(*column_rare);
+	results_free(*results);
+	*results = NULL;
+	if ((*column_rare = hashtable_new(RARE_SLOTS)) == NULL || (*results = results_new()) == NULL) {
+		fprintf(stderr, "Malloc error for results\n");
+		return;
+	}
+	job.results = *results;
+
+	if ((job.stat = spill_runs_merge(runs, &job, count_merged)) != 0) {
+		fprintf(stderr, "Error reading columns back from disk\n");
+		return;
+	}
+	// Tables are empty, so work out avg from words counted instead
+	if ((avg = csv_data_avg_probability_new(info, col)) == NULL) {
+		fprintf(stderr, "Malloc error for avg probability\n");
+		return;
+	}
+	*avg = (float)1 / (float)job.words_n;
+	job.avg = *avg;
+	job.rare_possible = is_rare(csv_data_get_min_count(info) / job.rows, *avg);
+
+	if (spill_runs_merge(runs, &job, collect_merged) != 0) {
+		fprintf(stderr, "Error reading columns back from disk\n");
+		return;
+	}
+	if (job.stat != 0 || results_sort(*results) != 0) {
+		fprintf(stderr, "Malloc error for results\n");
+	}
+}
+
+/* Counts a unique word in a spilled col, in a spill merge function
+ * @param data merged_job_t ptr
+ * @param key word
+ * @param count word's freq summed over runs
+ */
+static void count_merged(void *data, const char *key, float count)
+{
+	merged_job_t *job = (merged_job_t *)data;
+
+	if (count >= csv_data_get_min_count(job->info)) { // Would've been dropped by decay if still in memory
+		job->words_n++;
+	}
+}
+
+/* Adds a word of a spilled col to its results if it's a null word of either kind, in a spill merge function
+ * @param data merged_job_t ptr
+ * @param key word
+ * @param count word's freq summed over runs
+ */
+static void collect_merged(void *data, const char *key, float count)
+{
+	merged_job_t *job = (merged_job_t *)data;
+	hashtable_t *column_nulls = *(csv_data_get_column_to_nulls(job->info) + job->col);
+	int stat = 0;
+
+	if (count < csv_data_get_min_count(job->info)) {
+		return;
+	}
+	if (hashtable_find(column_nulls, key) != NULL) {
+		stat = results_add(job->results, key, count);
+	}
+	else if (job->rare_possible && is_rare(count / job->rows, job->avg) && is_candidate(key)) {
+		char *dummy = malloc(sizeof(char));
+		if (dummy == NULL || hashtable_insert(*(csv_data_get_column_to_rare(job->info) + job->col), key, dummy) != 0) {
+			free(dummy);
+		}
+		stat = results_add(job->results, key, count);
+	}
+	// Empty fields are reported as <empty>; freqs of both get summed once results are sorted
+	if (key[0] == '\0' && hashtable_find(column_nulls, "<empty>") != NULL) {
+		stat = (stat != 0) ? stat : results_add(job->results, "<empty>", count);
+	}
+	if (stat != 0) {
+		job->stat = stat;
+	}
+}
@@ -0,0 +1,214 @@
+/* Library for finding null-equivalent words in csv data held in memory
+ * Push data in (raw csv bytes in any sized pieces, or rows already split into fields),
+ * finalize, then iterate through potential null words found in each column
+ * First row pushed in is always taken as the header and isn't analyzed
+ */
+
+#ifndef __NULLFINDER_H
+#define __NULLFINDER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "matcher.h"
+#include "dialect.h"
+#include "results.h"
+
+/* Type definition */
+typedef struct nullfinder nullfinder_t;
+
+// What to do w/ rows that don't have as many fields as header
+typedef enum bad_rows {
+	BAD_ROWS_COUNT, // Count fields it does have like any other row (more cols added if needed) (default)
+	BAD_ROWS_SKIP, // Leave row out
+	BAD_ROWS_QUARANTINE // Leave row out & write it to a side file
+} bad_rows_t;
+
+/* Initialize a new analyzer
+ * @param null_words ALREADY POPULATED array of pre-defined null words; not copied, must outlive analyzer
+ * @param nulls_n number of words in null_words
+ * @param rows number of data rows if known up front (sizes tables, probabilities use it); <= 0 to count rows as they come
+ * @return ptr to new analyzer or NULL if error
+ */
+nullfinder_t *nullfinder_new(char **null_words, int nulls_n, int rows);
+
+/* Initialize a new analyzer using a null words matcher that's already built, e.g. to share one among many analyzers
+ * @param nulls matcher built from null words; not freed w/ analyzer, must outlive it
+ * @param rows as in nullfinder_new
+ * @return ptr to new analyzer or NULL if error
+ */
+nullfinder_t *nullfinder_new_shared(matcher_t *nulls, int rows);
+
+/* Say data fed in has no header row of its own (e.g. a later piece of a split file),
+ * so every row fed in is analyzed; must be called before feeding anything
+ * @param nf analyzer to modify
+ * @param cols_n # columns, as in header
+ * @return exit status
+ */
+int nullfinder_set_cols_n(nullfinder_t *nf, int cols_n);
+
+/* Set # threads used when finalizing (default is # of processors)
+ * @param nf analyzer to modify
+ * @param threads_n thread #, at least 1
+ * @return exit status
+ */
+int nullfinder_set_threads(nullfinder_t *nf, int threads_n);
+
+/* Set how data fed in is written (default: comma, double quotes, lenient, UTF-8); must be called before feeding anything
+ * See dialect.h for guessing it from start of data
+ * @param nf analyzer to modify
+ * @param dialect delimiter, quote char, strictness (quotes out of place are parse errors), encoding (fields converted to UTF-8)
+ * @return exit status
+ */
+int nullfinder_set_dialect(nullfinder_t *nf, const dialect_t *dialect);
+
+/* Set what to do w/ rows that don't have as many fields as header; must be called before feeding anything
+ * @param nf analyzer to modify
+ * @param policy one of bad_rows_t
+ * @param quarantine file rows left out are written to if quarantining (written whole rows at a time, so can be shared
+ *	among analyzers in different threads), otherwise ignored
+ * @return exit status
+ */
+int nullfinder_set_bad_rows(nullfinder_t *nf, bad_rows_t policy, FILE *quarantine);
+
+/* Hold each row's fields til whole row's read even when counting bad rows (see nullfinder_set_bad_rows; always done
+ * when leaving them out), so column slots can be prefetched a few fields ahead; helps on wide tables too big for cache
+ * Must be called before feeding anything
+ * @param nf analyzer to modify
+ * @param prefetch true to prefetch
+ * @return exit status
+ */
+int nullfinder_set_prefetch(nullfinder_t *nf, bool prefetch);
+
+/* Set how much memory column tables can take up; once over, biggest columns' freqs are sorted & spilled
+ * to a temp file in $TMPDIR (or /tmp) & their tables start over, til they're down to half of it
+ * Spilled runs are merged back when finishing, so results are exact, just slower
+ * Can be changed any time before finalizing
+ * @param nf analyzer to modify
+ * @param bytes memory budget, 0 for none (default)
+ * @return exit status
+ */
+int nullfinder_set_memory_limit(nullfinder_t *nf, size_t bytes);
+
+/* Spill every column's freqs to disk right away, freeing up memory they took (e.g. analyzer of a piece waiting
+ * to be merged); analyzer can still be fed, merged & finalized as usual after
+ * @param nf analyzer, not finalized
+ * @return exit status
+ */
+int nullfinder_spill(nullfinder_t *nf);
+
+/* Feed raw csv bytes; buffer can end anywhere, incl. in middle of a field
+ * If parser gives up on some data, row it was in is left out, rest of that line's skipped (& quarantined if quarantining),
+ * & parsing picks up again on the next line
+ * @param nf analyzer
+ * @param buf csv bytes
+ * @param len # bytes in buf
+ * @return exit status (4 if parser can't be started over)
+ */
+int nullfinder_feed(nullfinder_t *nf, const char *buf, size_t len);
+
+/* Feed a single row that's already been split into fields
+ * @param nf analyzer
+ * @param fields array of field strings (need not be null-terminated)
+ * @param lens length of each field
+ * @param fields_n # fields in row
+ * @return exit status
+ */
+int nullfinder_feed_row(nullfinder_t *nf, const char **fields, const size_t *lens, int fields_n);
+
+/* Fold everything fed into src into dst, as if it had been fed into dst
+ * For putting together analyzers that were each fed a different piece of the same data
+ * Anything src spilled to disk is handed over as is, not read back in
+ * Neither can be finalized yet; src can't be fed anything more after, only freed
+ * @param dst analyzer to merge into
+ * @param src analyzer to merge from (dst gets more columns if src has more)
+ * @return exit status
+ */
+int nullfinder_merge(nullfinder_t *dst, nullfinder_t *src);
+
+/* Finish analysis once everything's fed in; nothing more can be fed after
+ * Columns are processed in parallel
+ * @param nf analyzer
+ * @return exit status
+ */
+int nullfinder_finalize(nullfinder_t *nf);
+
+/* Get # columns seen (from header row)
+ * @param nf analyzer
+ * @return # cols or -1 if error
+ */
+int nullfinder_get_cols_n(nullfinder_t *nf);
+
+/* Get # data rows seen so far (header not included)
+ * @param nf analyzer
+ * @return # rows or -1 if error
+ */
+int nullfinder_get_rows_read(nullfinder_t *nf);
+
+/* Work out null words from everything fed in so far, w/o finishing; can keep feeding after,
+ * & call again any time for updated results (e.g. periodic reports on a stream)
+ * Last row is only counted once it's complete
+ * @param nf analyzer
+ * @return exit status
+ */
+int nullfinder_evaluate(nullfinder_t *nf);
+
+/* Scale down every freq counted so far, so older rows count for less than newer ones
+ * Words whose freq falls below min_count are dropped (so memory stays bounded on a never-ending stream),
+ * along w/ any null words found for them
+ * @param nf analyzer, not finalized
+ * @param factor what to multiply freqs by, in (0, 1]
+ * @param min_count lowest freq to keep
+ * @return exit status
+ */
+int nullfinder_decay(nullfinder_t *nf, float factor, float min_count);
+
+/* Get # rows that didn't have as many fields as header, whether counted or left out
+ * @param nf analyzer
+ * @return # rows or -1 if error
+ */
+int nullfinder_get_bad_rows(nullfinder_t *nf);
+
+/* Get # times parser gave up on data fed in
+ * @param nf analyzer
+ * @return # parse errors or -1 if error
+ */
+int nullfinder_get_parse_errors(nullfinder_t *nf);
+
+/* Get # bytes skipped after parse errors
+ * @param nf analyzer
+ * @return # bytes or -1 if error
+ */
+long nullfinder_get_skipped(nullfinder_t *nf);
+
+/* Whether raw bytes fed so far stop partway into a row, e.g. inside a quoted field w/ newlines in it,
+ * i.e. they aren't a whole # rows
+ * @param nf analyzer
+ * @return true if partway into a row, false if at start of one (or error)
+ */
+bool nullfinder_mid_row(nullfinder_t *nf);
+
+/* Iterate through potential null words found in a column in sorted order, applying func to each; only after finalizing/evaluating
+ * Empty fields show up as <empty>
+ * @param nf analyzer
+ * @param col index of column (0 is 1st col)
+ * @param data whatever user wants to pass to func
+ * @param func function applied to every null word
+ * @return exit status
+ */
+int nullfinder_iterate(nullfinder_t *nf, int col, void *data, void (*func)(void *data, const char *word));
+
+/* Get every potential null word found in a column w/ its freq, sorted by word; only after finalizing/evaluating
+ * Same words as nullfinder_iterate, in same order; can be merged w/ results from other analyzers (see results.h)
+ * @param nf analyzer
+ * @param col index of column (0 is 1st col)
+ * @return column's results, owned by analyzer & redone if evaluated again; NULL if error
+ */
+const results_t *nullfinder_get_results(nullfinder_t *nf, int col);
+
+/* Frees up everything in analyzer (but not null words passed in)
+ * @param nf analyzer to free
+ */
+void nullfinder_free(nullfinder_t *nf);
+
+#endif
@@ -0,0 +1,118 @@
+/* Hardware event counters' .c file
+ * See .h file for more details on each function
+ */
+
+#define _DEFAULT_SOURCE // syscall
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "perfcount.h"
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/* Global type */
+typedef struct perfcount {
+	int fds[PERFCOUNT_EVENTS_N]; // -1 if event can't be counted
+} perfcount_t;
+
+// Local function declaration
+static int open_event(perfcount_event_t event);
+
+perfcount_t *perfcount_new(void)
+{
+	perfcount_t *new = malloc(sizeof(perfcount_t));
+	if (new == NULL) {
+		return NULL;
+	}
+
+	for (int i = 0; i < PERFCOUNT_EVENTS_N; i++) {
+		new->fds[i] = open_event((perfcount_event_t)i);
+	}
+	return new;
+}
+
+void perfcount_start(perfcount_t *pc)
+{
+#ifdef __linux__
+	if (pc != NULL) {
+		for (int i = 0; i < PERFCOUNT_EVENTS_N; i++) {
+			if (pc->fds[i] >= 0) {
+				ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+				ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+	}
+#endif
+}
+
+void perfcount_stop(perfcount_t *pc)
+{
+#ifdef __linux__
+	if (pc != NULL) {
+		for (int i = 0; i < PERFCOUNT_EVENTS_N; i++) {
+			if (pc->fds[i] >= 0) {
+				ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+	}
+#endif
+}
+
+long long perfcount_get(perfcount_t *pc, perfcount_event_t event)
+{
+	long long count;
+
+	if (pc == NULL || event < 0 || event >= PERFCOUNT_EVENTS_N || pc->fds[event] < 0) {
+		return -1;
+	}
+	if (read(pc->fds[event], &count, sizeof(count)) != sizeof(count)) {
+		return -1;
+	}
+	return count;
+}
+
+void perfcount_free(perfcount_t *pc)
+{
+	if (pc != NULL) {
+		for (int i = 0; i < PERFCOUNT_EVENTS_N; i++) {
+			if (pc->fds[i] >= 0) {
+				close(pc->fds[i]);
+			}
+		}
+		free(pc);
+	}
+}
+
+/* Opens a disabled counter for an event on calling thread, inherited by threads it starts after
+ * @param event one of perfcount_event_t
+ * @return file descriptor, -1 if event can't be counted
+ */
+static int open_event(perfcount_event_t event)
+{
+#ifdef __linux__
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.disabled = 1;
+	attr.inherit = 1; // Worker threads finishing off cols count too
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	if (event == PERFCOUNT_CACHE_MISSES) {
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	}
+	else {
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	}
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	return -1;
+#endif
+}
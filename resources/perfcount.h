@@ -0,0 +1,48 @@
+/* Hardware event counters for bench mode: cache & TLB misses of calling thread (& threads it starts) while counting
+ * Uses perf_event_open on Linux; anywhere counters can't be opened (other OSes, perf_event_paranoid, VMs) they read as -1
+ */
+
+#ifndef __PERFCOUNT_H
+#define __PERFCOUNT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Events counted
+typedef enum perfcount_event {
+	PERFCOUNT_CACHE_MISSES, // Last level cache misses
+	PERFCOUNT_DTLB_MISSES, // Data TLB load misses
+	PERFCOUNT_EVENTS_N
+} perfcount_event_t;
+
+/* Type definition */
+typedef struct perfcount perfcount_t;
+
+/* Open counters for every event, stopped & at 0
+ * @return ptr to new counters (even if some couldn't be opened) or NULL if malloc error
+ */
+perfcount_t *perfcount_new(void);
+
+/* Zero every counter & start counting
+ * @param pc counters
+ */
+void perfcount_start(perfcount_t *pc);
+
+/* Stop counting
+ * @param pc counters
+ */
+void perfcount_stop(perfcount_t *pc);
+
+/* Get count of an event between last start & stop
+ * @param pc counters
+ * @param event one of perfcount_event_t
+ * @return count, -1 if event can't be counted
+ */
+long long perfcount_get(perfcount_t *pc, perfcount_event_t event);
+
+/* Closes counters
+ * @param pc counters to free
+ */
+void perfcount_free(perfcount_t *pc);
+
+#endif
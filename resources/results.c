@@ -0,0 +1,142 @@
+/* Result set's .c file
+ * See .h file for more details on each function
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "results.h"
+
+/* Local types */
+
+// A single null word & its freq
+typedef struct result {
+	char *word;
+	float count;
+} result_t;
+
+/* Global type */
+typedef struct results {
+	result_t *items; // Grows by doubling
+	int items_n;
+	int cap;
+} results_t;
+
+// Local function declaration
+static int reserve(results_t *set, int n);
+static int compare_results(const void *a, const void *b);
+
+results_t *results_new(void)
+{
+	results_t *new = malloc(sizeof(results_t));
+	if (new == NULL) {
+		return NULL;
+	}
+
+	new->items = NULL;
+	new->items_n = 0;
+	new->cap = 0;
+
+	return new;
+}
+
+int results_add(results_t *set, const char *word, float count)
+{
+	if (set == NULL || word == NULL) {
+		return 2;
+	}
+	if (reserve(set, set->items_n + 1) != 0) {
+		return 4;
+	}
+	if ((set->items[set->items_n].word = malloc(strlen(word)+1)) == NULL) {
+		return 4;
+	}
+	strcpy(set->items[set->items_n].word, word);
+	set->items[set->items_n].count = count;
+	set->items_n++;
+	return 0;
+}
+
+int results_sort(results_t *set)
+{
+	if (set == NULL) {
+		return 2;
+	}
+	if (set->items_n == 0) {
+		return 0;
+	}
+
+	qsort(set->items, set->items_n, sizeof(result_t), compare_results);
+	// Fold repeats into 1st of their run
+	int kept = 0;
+	for (int i = 1; i < set->items_n; i++) {
+		if (strcmp(set->items[i].word, set->items[kept].word) == 0) {
+			set->items[kept].count += set->items[i].count;
+			free(set->items[i].word);
+		}
+		else {
+			set->items[++kept] = set->items[i];
+		}
+	}
+	set->items_n = kept + 1;
+	return 0;
+}
+
+int results_get_n(const results_t *set)
+{
+	if (set != NULL) {return set->items_n;}
+	return -1;
+}
+
+void results_iterate(const results_t *set, void *data, void (*func)(void *data, const char *word, float count))
+{
+	if (set != NULL && func != NULL) {
+		for (int i = 0; i < set->items_n; i++) {
+			(*func)(data, set->items[i].word, set->items[i].count);
+		}
+	}
+}
+
+void results_free(results_t *set)
+{
+	if (set != NULL) {
+		for (int i = 0; i < set->items_n; i++) {
+			free(set->items[i].word);
+		}
+		free(set->items);
+		free(set);
+	}
+}
+
+/* Makes sure there's room for n items
+ * @param set result set to grow
+ * @param n # items needed
+ * @return exit status
+ */
+static int reserve(results_t *set, int n)
+{
+	if (n <= set->cap) {
+		return 0;
+	}
+	int cap = (set->cap == 0) ? 16 : set->cap;
+	while (cap < n) {
+		cap *= 2;
+	}
+	result_t *items = realloc(set->items, cap * sizeof(result_t));
+	if (items == NULL) {
+		return 4;
+	}
+	set->items = items;
+	set->cap = cap;
+	return 0;
+}
+
+/* Orders results by word, byte by byte, for qsort
+ * @param a result_t ptr
+ * @param b result_t ptr
+ * @return < 0, 0, > 0 as in strcmp
+ */
+static int compare_results(const void *a, const void *b)
+{
+	return strcmp(((const result_t *)a)->word, ((const result_t *)b)->word);
+}
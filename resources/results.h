@@ -0,0 +1,51 @@
+/* Results: null words found in a column, w/ their freqs, kept sorted by word (byte order)
+ * Sorted order doesn't depend on table sizes or hashing, so reports come out the same no matter what rows # was given
+ */
+
+#ifndef __RESULTS_H
+#define __RESULTS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Type definition */
+typedef struct results results_t;
+
+/* Initialize a new empty result set
+ * @return ptr to new result set or NULL if error
+ */
+results_t *results_new(void);
+
+/* Add a word to result set; set isn't sorted again til results_sort
+ * @param set result set to add to
+ * @param word null word (copied)
+ * @param count word's freq
+ * @return exit status
+ */
+int results_add(results_t *set, const char *word, float count);
+
+/* Sort result set by word, summing freqs of any word added more than once
+ * @param set result set to sort
+ * @return exit status
+ */
+int results_sort(results_t *set);
+
+/* Get # words in result set
+ * @param set result set of interest
+ * @return # words or -1 if error
+ */
+int results_get_n(const results_t *set);
+
+/* Iterate through result set in order, applying func to every word
+ * @param set result set to iterate through
+ * @param data whatever user wants to pass to func
+ * @param func function applied to every word & its freq
+ */
+void results_iterate(const results_t *set, void *data, void (*func)(void *data, const char *word, float count));
+
+/* Frees up result set
+ * @param set result set to free
+ */
+void results_free(results_t *set);
+
+#endif
@@ -0,0 +1,421 @@
+/* Spill's .c file
+ * See .h file for more details on each function
+ *
+ * A run is words back to back, sorted, each as: uint32_t length, word w/ '\0', float freq
+ * Every run of an analyzer goes in the same file one after another; merging reads them w/ pread,
+ * each run through its own buffer, so any # of cols can be merged at once off 1 file descriptor
+ */
+
+#define _POSIX_C_SOURCE 200809L // mkstemp, fdopen, pread
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "spill.h"
+
+#define READ_BUF 65536 // Bytes read from a run at a time while merging
+
+/* Global types */
+typedef struct spill_file {
+	int fd;
+	FILE *fp; // Same file, for writing runs
+	long size; // Bytes in file, where next run starts
+	int refs; // Runs in file + 1 for whoever made it
+	pthread_mutex_t lock; // Guards refs; runs in a file can end up in different analyzers
+} spill_file_t;
+
+/* Local types */
+
+// Where a single run is
+typedef struct run {
+	spill_file_t *file;
+	long start;
+	long end;
+	float scale; // Freqs multiplied by this when read back
+} run_t;
+
+typedef struct spill_runs {
+	run_t *runs; // Grows by doubling
+	int runs_n;
+	int cap;
+} spill_runs_t;
+
+// Reads a single run while merging
+typedef struct cursor {
+	const run_t *run;
+	long pos; // Next byte of file to read into buffer
+	char *buf;
+	size_t buf_cap;
+	size_t buf_len; // Bytes in buffer
+	size_t buf_pos; // Next record in buffer
+	const char *key; // Current word, points into buffer til next read
+	size_t key_len;
+	float count;
+} cursor_t;
+
+// Local function declaration
+static void file_release(spill_file_t *file);
+static int reserve(spill_runs_t *runs, int n);
+static int compare_items(const void *a, const void *b);
+static int cursor_fill(cursor_t *cur, size_t need);
+static int cursor_next(cursor_t *cur);
+static void sift_down(cursor_t **heap, int heap_n, int i);
+
+spill_file_t *spill_file_new(void)
+{
+	const char *dir = getenv("TMPDIR");
+	const char *name = "/nullfinder_spill_XXXXXX";
+	spill_file_t *new;
+	char *path;
+
+	if (dir == NULL || dir[0] == '\0') {
+		dir = "/tmp";
+	}
+	if ((new = malloc(sizeof(spill_file_t))) == NULL) {
+		return NULL;
+	}
+	if ((path = malloc(strlen(dir) + strlen(name) + 1)) == NULL) {
+		free(new);
+		return NULL;
+	}
+	strcpy(path, dir);
+	strcat(path, name);
+	if ((new->fd = mkstemp(path)) < 0) {
+		free(path);
+		free(new);
+		return NULL;
+	}
+	unlink(path); // Still there for us til closed
+	free(path);
+	if ((new->fp = fdopen(new->fd, "w")) == NULL) {
+		close(new->fd);
+		free(new);
+		return NULL;
+	}
+
+	new->size = 0;
+	new->refs = 1;
+	pthread_mutex_init(&new->lock, NULL);
+	return new;
+}
+
+void spill_file_free(spill_file_t *file)
+{
+	if (file != NULL) {
+		file_release(file);
+	}
+}
+
+spill_runs_t *spill_runs_new(void)
+{
+	spill_runs_t *new = malloc(sizeof(spill_runs_t));
+	if (new == NULL) {
+		return NULL;
+	}
+
+	new->runs = NULL;
+	new->runs_n = 0;
+	new->cap = 0;
+
+	return new;
+}
+
+int spill_runs_write(spill_runs_t *runs, spill_file_t *file, spill_item_t *items, int items_n)
+{
+	if (runs == NULL || file == NULL || (items == NULL && items_n > 0)) {
+		return 2;
+	}
+	if (items_n == 0) { // Nothing to write, no run needed
+		return 0;
+	}
+	if (reserve(runs, runs->runs_n + 1) != 0) {
+		return 4;
+	}
+
+	qsort(items, items_n, sizeof(spill_item_t), compare_items);
+	long size = file->size;
+	for (int i = 0; i < items_n; i++) {
+		uint32_t len = (uint32_t)strlen(items[i].key);
+
+		fwrite(&len, sizeof(uint32_t), 1, file->fp);
+		fwrite(items[i].key, sizeof(char), len + 1, file->fp);
+		fwrite(&items[i].count, sizeof(float), 1, file->fp);
+		size += sizeof(uint32_t) + len + 1 + sizeof(float);
+	}
+	if (fflush(file->fp) != 0 || ferror(file->fp)) { // Disk full; next run goes over what got written of this one
+		clearerr(file->fp);
+		fseek(file->fp, file->size, SEEK_SET);
+		return 4;
+	}
+
+	run_t *run = &runs->runs[runs->runs_n++];
+	run->file = file;
+	run->start = file->size;
+	run->end = size;
+	run->scale = 1;
+	file->size = size;
+	pthread_mutex_lock(&file->lock);
+	file->refs++;
+	pthread_mutex_unlock(&file->lock);
+	return 0;
+}
+
+int spill_runs_get_n(spill_runs_t *runs)
+{
+	if (runs != NULL) {return runs->runs_n;}
+	return -1;
+}
+
+void spill_runs_scale(spill_runs_t *runs, float factor)
+{
+	if (runs != NULL) {
+		for (int i = 0; i < runs->runs_n; i++) {
+			runs->runs[i].scale *= factor;
+		}
+	}
+}
+
+int spill_runs_adopt(spill_runs_t *dst, spill_runs_t *src)
+{
+	if (dst == NULL || src == NULL || dst == src) {
+		return 2;
+	}
+	if (reserve(dst, dst->runs_n + src->runs_n) != 0) {
+		return 4;
+	}
+
+	// Each run holds onto its file, so file refs just go along w/ them
+	memcpy(&dst->runs[dst->runs_n], src->runs, src->runs_n * sizeof(run_t));
+	dst->runs_n += src->runs_n;
+	src->runs_n = 0;
+	return 0;
+}
+
+int spill_runs_merge(spill_runs_t *runs, void *data, void (*func)(void *data, const char *key, float count))
+{
+	if (runs == NULL || func == NULL) {
+		return 2;
+	}
+	if (runs->runs_n == 0) {
+		return 0;
+	}
+
+	cursor_t *cursors = calloc(runs->runs_n, sizeof(cursor_t));
+	cursor_t **heap = malloc(runs->runs_n * sizeof(cursor_t *)); // Min-heap of cursors by current word
+	int heap_n = 0;
+	char *last = NULL; // Word being summed, copied since cursors move on
+	size_t last_cap = 0;
+	int stat = 0;
+
+	if (cursors == NULL || heap == NULL) {
+		free(cursors);
+		free(heap);
+		return 4;
+	}
+	for (int i = 0; i < runs->runs_n && stat == 0; i++) {
+		cursors[i].run = &runs->runs[i];
+		cursors[i].pos = runs->runs[i].start;
+		int got = cursor_next(&cursors[i]);
+		if (got == 0) {
+			heap[heap_n++] = &cursors[i];
+		}
+		else if (got != 1) {
+			stat = got;
+		}
+	}
+	for (int i = heap_n / 2 - 1; i >= 0; i--) {
+		sift_down(heap, heap_n, i);
+	}
+
+	while (heap_n > 0 && stat == 0) {
+		float total = 0;
+
+		if (heap[0]->key_len + 1 > last_cap) {
+			char *grown = realloc(last, heap[0]->key_len + 1);
+			if (grown == NULL) {
+				stat = 4;
+				break;
+			}
+			last = grown;
+			last_cap = heap[0]->key_len + 1;
+		}
+		memcpy(last, heap[0]->key, heap[0]->key_len + 1);
+
+		// Word's in each run at most once, so every cursor on it is at the top in turn
+		while (heap_n > 0 && strcmp(heap[0]->key, last) == 0) {
+			total += heap[0]->count * heap[0]->run->scale;
+			int got = cursor_next(heap[0]);
+			if (got == 1) { // Run's done
+				heap[0] = heap[--heap_n];
+			}
+			else if (got != 0) {
+				stat = got;
+				break;
+			}
+			sift_down(heap, heap_n, 0);
+		}
+		if (stat == 0) {
+			(*func)(data, last, total);
+		}
+	}
+
+	for (int i = 0; i < runs->runs_n; i++) {
+		free(cursors[i].buf);
+	}
+	free(cursors);
+	free(heap);
+	free(last);
+	return stat;
+}
+
+void spill_runs_free(spill_runs_t *runs)
+{
+	if (runs != NULL) {
+		for (int i = 0; i < runs->runs_n; i++) {
+			file_release(runs->runs[i].file);
+		}
+		free(runs->runs);
+		free(runs);
+	}
+}
+
+/* Drops a reference to file, closing it once there are none left
+ * @param file file to let go of
+ */
+static void file_release(spill_file_t *file)
+{
+	pthread_mutex_lock(&file->lock);
+	int refs = --file->refs;
+	pthread_mutex_unlock(&file->lock);
+
+	if (refs == 0) {
+		fclose(file->fp); // Closes fd too
+		pthread_mutex_destroy(&file->lock);
+		free(file);
+	}
+}
+
+/* Makes sure there's room for n runs
+ * @param runs runs to grow
+ * @param n # runs needed
+ * @return exit status
+ */
+static int reserve(spill_runs_t *runs, int n)
+{
+	if (n <= runs->cap) {
+		return 0;
+	}
+	int cap = (runs->cap == 0) ? 4 : runs->cap;
+	while (cap < n) {
+		cap *= 2;
+	}
+	run_t *grown = realloc(runs->runs, cap * sizeof(run_t));
+	if (grown == NULL) {
+		return 4;
+	}
+	runs->runs = grown;
+	runs->cap = cap;
+	return 0;
+}
+
+/* Orders items by word, byte by byte, for qsort
+ * @param a spill_item_t ptr
+ * @param b spill_item_t ptr
+ * @return < 0, 0, > 0 as in strcmp
+ */
+static int compare_items(const void *a, const void *b)
+{
+	return strcmp(((const spill_item_t *)a)->key, ((const spill_item_t *)b)->key);
+}
+
+/* Makes sure at least need bytes of run are in cursor's buffer past next record, reading more if not
+ * @param cur cursor
+ * @param need # bytes
+ * @return exit status (1 if run ends before that)
+ */
+static int cursor_fill(cursor_t *cur, size_t need)
+{
+	if (cur->buf_len - cur->buf_pos >= need) {
+		return 0;
+	}
+
+	// Move what's left to front, growing buffer if a record's bigger than it
+	if (cur->buf_pos > 0) {
+		memmove(cur->buf, cur->buf + cur->buf_pos, cur->buf_len - cur->buf_pos);
+		cur->buf_len -= cur->buf_pos;
+		cur->buf_pos = 0;
+	}
+	if (need > cur->buf_cap) {
+		size_t cap = (need > READ_BUF) ? need : READ_BUF;
+		char *grown = realloc(cur->buf, cap);
+		if (grown == NULL) {
+			return 4;
+		}
+		cur->buf = grown;
+		cur->buf_cap = cap;
+	}
+	while (cur->buf_len < need) {
+		size_t want = cur->buf_cap - cur->buf_len;
+		if ((long)want > cur->run->end - cur->pos) {
+			want = cur->run->end - cur->pos;
+		}
+		if (want == 0) {
+			return 1;
+		}
+		ssize_t got = pread(cur->run->file->fd, cur->buf + cur->buf_len, want, cur->pos);
+		if (got <= 0) {
+			return 4;
+		}
+		cur->buf_len += got;
+		cur->pos += got;
+	}
+	return 0;
+}
+
+/* Moves cursor on to next word in its run
+ * @param cur cursor
+ * @return exit status (1 if run's done)
+ */
+static int cursor_next(cursor_t *cur)
+{
+	uint32_t len;
+	int stat;
+
+	if ((stat = cursor_fill(cur, sizeof(uint32_t))) != 0) {
+		return (stat == 1 && cur->buf_len == cur->buf_pos) ? 1 : 4; // Ends cleanly only btwn records
+	}
+	memcpy(&len, cur->buf + cur->buf_pos, sizeof(uint32_t));
+	if ((stat = cursor_fill(cur, sizeof(uint32_t) + len + 1 + sizeof(float))) != 0) {
+		return 4;
+	}
+	cur->key = cur->buf + cur->buf_pos + sizeof(uint32_t);
+	cur->key_len = len;
+	memcpy(&cur->count, cur->key + len + 1, sizeof(float));
+	cur->buf_pos += sizeof(uint32_t) + len + 1 + sizeof(float);
+	return 0;
+}
+
+/* Moves cursor at i down heap til it's no bigger than its children
+ * @param heap min-heap of cursors, by current word
+ * @param heap_n # cursors in heap
+ * @param i index of cursor to move
+ */
+static void sift_down(cursor_t **heap, int heap_n, int i)
+{
+	while (2*i + 1 < heap_n) {
+		int child = 2*i + 1;
+		if (child + 1 < heap_n && strcmp(heap[child + 1]->key, heap[child]->key) < 0) {
+			child++;
+		}
+		if (strcmp(heap[i]->key, heap[child]->key) <= 0) {
+			return;
+		}
+		cursor_t *tmp = heap[i];
+		heap[i] = heap[child];
+		heap[child] = tmp;
+		i = child;
+	}
+}
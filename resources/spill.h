@@ -0,0 +1,80 @@
+/* Spill: lets a column's freqs outgrow memory
+ * Once tables get too big, a column's words & freqs are sorted & written out as a run to a temp file,
+ * & table starts over empty. When col's finished, its runs are merged (k-way) back into one sorted stream
+ * w/ every word's exact freq, summed across runs
+ */
+
+#ifndef __SPILL_H
+#define __SPILL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// A word & its freq to write out
+typedef struct spill_item {
+	const char *key;
+	float count;
+} spill_item_t;
+
+/* Type definitions */
+typedef struct spill_file spill_file_t; // Temp file runs are written to, shared by every col of an analyzer
+typedef struct spill_runs spill_runs_t; // Runs of a single col
+
+/* Make a new temp file in $TMPDIR (or /tmp); it's unlinked right away, so it's gone once closed however program ends
+ * @return ptr to new file or NULL if error
+ */
+spill_file_t *spill_file_new(void);
+
+/* Let go of file; it's closed once every run in it has been let go of too
+ * @param file file to let go of
+ */
+void spill_file_free(spill_file_t *file);
+
+/* Initialize a new empty list of runs
+ * @return ptr to new runs or NULL if error
+ */
+spill_runs_t *spill_runs_new(void);
+
+/* Sort words & write them out to file as a new run
+ * @param runs col's runs to add to
+ * @param file file to write to, only ever written by one thread
+ * @param items words & freqs, each word once; sorted in place
+ * @param items_n # items
+ * @return exit status
+ */
+int spill_runs_write(spill_runs_t *runs, spill_file_t *file, spill_item_t *items, int items_n);
+
+/* Get # runs
+ * @param runs runs of interest
+ * @return # runs or -1 if error
+ */
+int spill_runs_get_n(spill_runs_t *runs);
+
+/* Scale freqs of every run written so far, applied as they're read back
+ * @param runs runs to scale
+ * @param factor what to multiply freqs by
+ */
+void spill_runs_scale(spill_runs_t *runs, float factor);
+
+/* Move every run of src over to dst (which may be in a different file), leaving src empty
+ * @param dst runs to add to
+ * @param src runs to take from
+ * @return exit status
+ */
+int spill_runs_adopt(spill_runs_t *dst, spill_runs_t *src);
+
+/* Merge every run, applying func to each word once, in sorted order, w/ its freq summed over runs
+ * Only reads files, so different cols can be merged by different threads at once
+ * @param runs runs to merge
+ * @param data whatever user wants to pass to func
+ * @param func function applied to every word
+ * @return exit status
+ */
+int spill_runs_merge(spill_runs_t *runs, void *data, void (*func)(void *data, const char *key, float count));
+
+/* Frees runs, letting go of files they're in
+ * @param runs runs to free
+ */
+void spill_runs_free(spill_runs_t *runs);
+
+#endif
@@ -0,0 +1,521 @@
+/* Typed column's .c file
+ * See .h file for more details on each function
+ *
+ * Values are packed into 64-bit keys:
+ * - numbers: signed mantissa (all digits, '.' dropped) shifted up 5 bits, # digits after '.' in low 5 bits
+ * - dates: yyyymmdd as an int
+ * Only canonical forms are packed (no leading zeros, no '+', no "-0"), so printing a key back
+ * gives exactly the cell it came from & no 2 different cells share a key
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "hugemem.h"
+#include "typed_column.h"
+
+#define MAX_DIGITS 17 // Mantissa must fit in 64 bits w/ 5 bits to spare
+#define MIN_SLOTS 64
+#define ONES 0x0101010101010101ULL
+
+/* Global type */
+typedef struct typed_column {
+	column_type_t type;
+	int sampled; // # non-empty cells sampled
+	int numbers; // # of those that were numbers
+	int dates; // # of those that were dates
+	uint64_t *keys; // Open addressing table of packed values
+	float *counts; // Freq of value in same slot of keys
+	unsigned char *used; // Whether slot has a value in it
+	int slots_n; // Always power of 2
+	int keys_n;
+} typed_column_t;
+
+// Local function declaration
+static size_t count_digits(const char *s, size_t len);
+static uint64_t digits_value(const char *s, size_t len);
+static bool parse_number(const char *s, size_t len, uint64_t *key);
+static bool parse_date(const char *s, size_t len, uint64_t *key);
+static void format_key(column_type_t type, uint64_t key, char *buf);
+static int find_slot(typed_column_t *tc, uint64_t key);
+static int grow(typed_column_t *tc);
+static int alloc_slots(typed_column_t *tc);
+static void free_slots(uint64_t *keys, float *counts, unsigned char *used, int slots_n);
+
+typed_column_t *typed_column_new(void)
+{
+	typed_column_t *new = malloc(sizeof(typed_column_t));
+	if (new == NULL) {
+		return NULL;
+	}
+
+	new->type = TYPE_SAMPLING;
+	new->sampled = 0;
+	new->numbers = 0;
+	new->dates = 0;
+	new->keys = NULL; // Table only made if column turns out typed
+	new->counts = NULL;
+	new->used = NULL;
+	new->slots_n = 0;
+	new->keys_n = 0;
+
+	return new;
+}
+
+column_type_t typed_column_get_type(typed_column_t *tc)
+{
+	if (tc != NULL) {return tc->type;}
+	return TYPE_STRING;
+}
+
+void typed_column_sample(typed_column_t *tc, const char *s, size_t len)
+{
+	if (tc != NULL && s != NULL && tc->type == TYPE_SAMPLING && len > 0) { // Empty cells say nothing about type
+		uint64_t key;
+
+		tc->sampled++;
+		if (parse_number(s, len, &key)) {
+			tc->numbers++;
+		}
+		else if (parse_date(s, len, &key)) {
+			tc->dates++;
+		}
+	}
+}
+
+column_type_t typed_column_decide(typed_column_t *tc, bool allowed)
+{
+	if (tc == NULL) {
+		return TYPE_STRING;
+	}
+	if (tc->type != TYPE_SAMPLING) {
+		return tc->type;
+	}
+
+	// Typed if at least 90% of non-empty cells fit; the odd one that doesn't is just counted as a string
+	tc->type = TYPE_STRING;
+	if (allowed && tc->sampled > 0) {
+		if (tc->numbers * 10 >= tc->sampled * 9) {
+			tc->type = TYPE_NUMBER;
+		}
+		else if (tc->dates * 10 >= tc->sampled * 9) {
+			tc->type = TYPE_DATE;
+		}
+	}
+
+	if (tc->type != TYPE_STRING) {
+		tc->slots_n = MIN_SLOTS;
+		if (alloc_slots(tc) != 0) { // Can't be typed, fine
+			tc->slots_n = 0;
+			tc->type = TYPE_STRING;
+		}
+	}
+	return tc->type;
+}
+
+void typed_column_abandon(typed_column_t *tc)
+{
+	if (tc != NULL) {
+		free_slots(tc->keys, tc->counts, tc->used, tc->slots_n);
+		tc->keys = NULL;
+		tc->counts = NULL;
+		tc->used = NULL;
+		tc->slots_n = 0;
+		tc->keys_n = 0;
+		tc->type = TYPE_STRING;
+	}
+}
+
+bool typed_column_add(typed_column_t *tc, const char *s, size_t len, float count)
+{
+	uint64_t key;
+
+	if (tc == NULL || s == NULL) {
+		return false;
+	}
+	if (tc->type == TYPE_NUMBER) {
+		if (!parse_number(s, len, &key)) {
+			return false;
+		}
+	}
+	else if (tc->type == TYPE_DATE) {
+		if (!parse_date(s, len, &key)) {
+			return false;
+		}
+	}
+	else {
+		return false;
+	}
+
+	int slot = find_slot(tc, key);
+	if (!tc->used[slot]) {
+		if ((tc->keys_n + 1) * 2 > tc->slots_n) { // Keep table at most half full
+			if (grow(tc) != 0) {
+				return false;
+			}
+			slot = find_slot(tc, key);
+		}
+		tc->used[slot] = 1;
+		tc->keys[slot] = key;
+		tc->counts[slot] = 0;
+		tc->keys_n++;
+	}
+	tc->counts[slot] += count;
+	return true;
+}
+
+float typed_column_get_count(typed_column_t *tc, const char *s, size_t len)
+{
+	uint64_t key;
+
+	if (tc == NULL || s == NULL || tc->keys_n == 0) {
+		return 0;
+	}
+	if (!(tc->type == TYPE_NUMBER && parse_number(s, len, &key)) && !(tc->type == TYPE_DATE && parse_date(s, len, &key))) {
+		return 0;
+	}
+	int slot = find_slot(tc, key);
+	return tc->used[slot] ? tc->counts[slot] : 0;
+}
+
+int typed_column_get_keys_n(typed_column_t *tc)
+{
+	if (tc != NULL) {return tc->keys_n;}
+	return -1;
+}
+
+size_t typed_column_get_size(typed_column_t *tc)
+{
+	if (tc != NULL) {return sizeof(typed_column_t) + tc->slots_n * (sizeof(uint64_t) + sizeof(float) + sizeof(unsigned char));}
+	return 0;
+}
+
+void typed_column_iterate(typed_column_t *tc, void *data, void (*func)(void *data, const char *key, void *val))
+{
+	if (tc != NULL && func != NULL) {
+		char buf[TYPED_KEY_MAX];
+
+		for (int i = 0; i < tc->slots_n; i++) {
+			if (tc->used[i]) {
+				format_key(tc->type, tc->keys[i], buf);
+				(*func)(data, buf, &tc->counts[i]);
+			}
+		}
+	}
+}
+
+void typed_column_iterate_rare(typed_column_t *tc, float max_count, void *data, void (*func)(void *data, const char *key, void *val))
+{
+	if (tc != NULL && func != NULL) {
+		char buf[TYPED_KEY_MAX];
+
+		for (int i = 0; i < tc->slots_n; i++) {
+			if (tc->used[i] && tc->counts[i] <= max_count) {
+				format_key(tc->type, tc->keys[i], buf);
+				(*func)(data, buf, &tc->counts[i]);
+			}
+		}
+	}
+}
+
+void typed_column_decay(typed_column_t *tc, float factor, float min_count)
+{
+	if (tc != NULL && tc->slots_n > 0) {
+		uint64_t *keys = malloc((tc->keys_n > 0 ? tc->keys_n : 1) * sizeof(uint64_t));
+		float *counts = malloc((tc->keys_n > 0 ? tc->keys_n : 1) * sizeof(float));
+		int kept = 0;
+
+		if (keys == NULL || counts == NULL) { // Can't drop any, just scale
+			for (int i = 0; i < tc->slots_n; i++) {
+				tc->counts[i] *= factor;
+			}
+			free(keys);
+			free(counts);
+			return;
+		}
+
+		// Pull out survivors, then put them back in their proper slots so lookups still work
+		for (int i = 0; i < tc->slots_n; i++) {
+			if (tc->used[i] && tc->counts[i] * factor >= min_count) {
+				keys[kept] = tc->keys[i];
+				counts[kept] = tc->counts[i] * factor;
+				kept++;
+			}
+		}
+		memset(tc->used, 0, tc->slots_n * sizeof(unsigned char));
+		for (int i = 0; i < kept; i++) {
+			int slot = find_slot(tc, keys[i]);
+			tc->used[slot] = 1;
+			tc->keys[slot] = keys[i];
+			tc->counts[slot] = counts[i];
+		}
+		tc->keys_n = kept;
+		free(keys);
+		free(counts);
+	}
+}
+
+int typed_column_clear(typed_column_t *tc)
+{
+	if (tc == NULL) {
+		return 2;
+	}
+	if (tc->slots_n == 0) { // Sampling, or not typed; nothing counted here
+		return 0;
+	}
+
+	free_slots(tc->keys, tc->counts, tc->used, tc->slots_n);
+	tc->slots_n = MIN_SLOTS;
+	tc->keys_n = 0;
+	if (alloc_slots(tc) != 0) { // Can't count anything here anymore, so strings from now on
+		tc->slots_n = 0;
+		tc->type = TYPE_STRING;
+		return 4;
+	}
+	return 0;
+}
+
+void typed_column_free(typed_column_t *tc)
+{
+	if (tc != NULL) {
+		free_slots(tc->keys, tc->counts, tc->used, tc->slots_n);
+		free(tc);
+	}
+}
+
+/* Counts how many digits string starts w/, checking 8 bytes at a time
+ * @param s string
+ * @param len length of string
+ * @return # leading digits
+ */
+static size_t count_digits(const char *s, size_t len)
+{
+	size_t i = 0;
+
+	// 8 bytes are all digits if every byte is 0x30-0x39: high nibble 3 before & after adding 6
+	while (i + 8 <= len) {
+		uint64_t x;
+		memcpy(&x, s + i, 8);
+		if ((x & (ONES * 0xF0)) != ONES * 0x30 || ((x + ONES * 0x06) & (ONES * 0xF0)) != ONES * 0x30) {
+			break; // Some non-digit in here, find it below
+		}
+		i += 8;
+	}
+	while (i < len && s[i] >= '0' && s[i] <= '9') {
+		i++;
+	}
+	return i;
+}
+
+/* Value of a run of digits, converting 8 at a time where possible
+ * @param s digits (all already checked to be digits)
+ * @param len # digits, at most MAX_DIGITS
+ * @return value
+ */
+static uint64_t digits_value(const char *s, size_t len)
+{
+	uint64_t val = 0;
+	size_t i = 0;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	// Combine neighbouring digits pairwise: 8 digits -> 4 2-digit #s -> 2 4-digit #s -> 1 8-digit #
+	while (i + 8 <= len) {
+		uint64_t x;
+		memcpy(&x, s + i, 8);
+		x -= ONES * '0';
+		x = (x * 10) + (x >> 8);
+		x = (((x & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) + (((x >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+		val = val * 100000000ULL + (x & 0xFFFFFFFFULL);
+		i += 8;
+	}
+#endif
+	for (; i < len; i++) {
+		val = val * 10 + (uint64_t)(s[i] - '0');
+	}
+	return val;
+}
+
+/* Parses a number in canonical form: optional '-', integer part w/ no leading zeros, optional '.' & digits
+ * @param s cell
+ * @param len length of cell
+ * @param key filled in w/ packed value if number
+ * @return whether cell is a number in canonical form
+ */
+static bool parse_number(const char *s, size_t len, uint64_t *key)
+{
+	bool neg = false;
+	size_t i = 0;
+	size_t int_len;
+	size_t frac_len = 0;
+
+	if (len > 0 && s[0] == '-') {
+		neg = true;
+		i = 1;
+	}
+	int_len = count_digits(s + i, len - i);
+	if (int_len == 0 || (int_len > 1 && s[i] == '0')) {
+		return false;
+	}
+	if (i + int_len < len) {
+		if (s[i + int_len] != '.') {
+			return false;
+		}
+		frac_len = count_digits(s + i + int_len + 1, len - i - int_len - 1);
+		if (frac_len == 0 || i + int_len + 1 + frac_len != len) {
+			return false;
+		}
+	}
+	if (int_len + frac_len > MAX_DIGITS) {
+		return false;
+	}
+
+	uint64_t mantissa = digits_value(s + i, int_len);
+	uint64_t frac = digits_value(s + i + int_len + 1, frac_len);
+	for (size_t j = 0; j < frac_len; j++) {
+		mantissa *= 10;
+	}
+	mantissa += frac;
+	if (neg && mantissa == 0) { // "-0" would print back as "0"
+		return false;
+	}
+
+	int64_t signed_mantissa = neg ? -(int64_t)mantissa : (int64_t)mantissa;
+	*key = ((uint64_t)signed_mantissa << 5) | (uint64_t)frac_len;
+	return true;
+}
+
+/* Parses an ISO date yyyy-mm-dd
+ * @param s cell
+ * @param len length of cell
+ * @param key filled in w/ packed value if date
+ * @return whether cell is a date
+ */
+static bool parse_date(const char *s, size_t len, uint64_t *key)
+{
+	if (len != 10 || s[4] != '-' || s[7] != '-' || count_digits(s, 4) != 4 || count_digits(s + 5, 2) != 2 || count_digits(s + 8, 2) != 2) {
+		return false;
+	}
+
+	uint64_t year = digits_value(s, 4);
+	uint64_t month = digits_value(s + 5, 2);
+	uint64_t day = digits_value(s + 8, 2);
+	if (month < 1 || month > 12 || day < 1 || day > 31) {
+		return false;
+	}
+
+	*key = year * 10000 + month * 100 + day;
+	return true;
+}
+
+/* Prints packed value back as the cell it came from
+ * @param type column type key is for
+ * @param key packed value
+ * @param buf filled in w/ cell, must have room for TYPED_KEY_MAX chars
+ */
+static void format_key(column_type_t type, uint64_t key, char *buf)
+{
+	if (type == TYPE_DATE) {
+		snprintf(buf, TYPED_KEY_MAX, "%04d-%02d-%02d", (int)(key / 10000), (int)(key / 100 % 100), (int)(key % 100));
+	}
+	else {
+		int scale = (int)(key & 31);
+		int64_t mantissa = (int64_t)key >> 5;
+		unsigned long long abs_mantissa = (mantissa < 0) ? (unsigned long long)(-mantissa) : (unsigned long long)mantissa;
+		char digits[TYPED_KEY_MAX];
+		int digits_n = snprintf(digits, sizeof(digits), "%0*llu", scale + 1, abs_mantissa);
+		char *out = buf;
+
+		if (mantissa < 0) {
+			*out++ = '-';
+		}
+		memcpy(out, digits, digits_n - scale);
+		out += digits_n - scale;
+		if (scale > 0) {
+			*out++ = '.';
+			memcpy(out, digits + digits_n - scale, scale);
+			out += scale;
+		}
+		*out = '\0';
+	}
+}
+
+/* Finds slot key is in, or empty slot it'd go in
+ * @param tc typed column to look in
+ * @param key packed value
+ * @return slot index
+ */
+static int find_slot(typed_column_t *tc, uint64_t key)
+{
+	unsigned mask = (unsigned)tc->slots_n - 1;
+	unsigned slot = (unsigned)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+	while (tc->used[slot] && tc->keys[slot] != key) {
+		slot = (slot + 1) & mask;
+	}
+	return (int)slot;
+}
+
+/* Doubles # slots in table, moving every value over
+ * @param tc typed column to grow
+ * @return exit status
+ */
+static int grow(typed_column_t *tc)
+{
+	uint64_t *keys = tc->keys;
+	float *counts = tc->counts;
+	unsigned char *used = tc->used;
+	int slots_n = tc->slots_n;
+
+	tc->slots_n = slots_n * 2;
+	if (tc->slots_n <= 0 || alloc_slots(tc) != 0) {
+		tc->keys = keys;
+		tc->counts = counts;
+		tc->used = used;
+		tc->slots_n = slots_n;
+		return 4;
+	}
+
+	for (int i = 0; i < slots_n; i++) {
+		if (used[i]) {
+			int slot = find_slot(tc, keys[i]);
+			tc->used[slot] = 1;
+			tc->keys[slot] = keys[i];
+			tc->counts[slot] = counts[i];
+		}
+	}
+	free_slots(keys, counts, used, slots_n);
+	return 0;
+}
+
+/* Allocates zeroed table arrays for tc->slots_n slots (w/ huge pages if big enough); old arrays not touched
+ * @param tc typed column, slots_n set already
+ * @return exit status, arrays NULL if not 0
+ */
+static int alloc_slots(typed_column_t *tc)
+{
+	tc->keys = hugemem_alloc(tc->slots_n * sizeof(uint64_t));
+	tc->counts = hugemem_alloc(tc->slots_n * sizeof(float));
+	tc->used = hugemem_alloc(tc->slots_n * sizeof(unsigned char));
+	if (tc->keys == NULL || tc->counts == NULL || tc->used == NULL) {
+		free_slots(tc->keys, tc->counts, tc->used, tc->slots_n);
+		tc->keys = NULL;
+		tc->counts = NULL;
+		tc->used = NULL;
+		return 4;
+	}
+	return 0;
+}
+
+/* Frees table arrays from alloc_slots
+ * @param keys keys array
+ * @param counts counts array
+ * @param used used array
+ * @param slots_n # slots arrays were allocated for
+ */
+static void free_slots(uint64_t *keys, float *counts, unsigned char *used, int slots_n)
+{
+	hugemem_free(keys, slots_n * sizeof(uint64_t));
+	hugemem_free(counts, slots_n * sizeof(float));
+	hugemem_free(used, slots_n * sizeof(unsigned char));
+}
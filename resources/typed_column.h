@@ -0,0 +1,125 @@
+/* Typed column: counts values of a column whose cells are (nearly) all numbers or dates
+ * w/o storing every value as a string key
+ *
+ * First rows of a column are sampled to guess its type. Once a column is typed, every cell that's
+ * in canonical form for that type (so it can be printed back exactly as it was read) is packed
+ * into a 64-bit key & counted in a compact table here; anything else (e.g. -1.#IND, n/a, ?)
+ * still goes through the regular string table
+ */
+
+#ifndef __TYPED_COLUMN_H
+#define __TYPED_COLUMN_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define TYPE_SAMPLE 100 // # rows sampled before deciding on type
+#define TYPED_KEY_MAX 24 // Room needed to print back any typed value, incl. '\0'
+
+/* Possible types for a column */
+typedef enum {
+	TYPE_SAMPLING, // Still deciding, nothing counted here yet
+	TYPE_STRING, // Not a typed column, everything in string table
+	TYPE_NUMBER, // Integers & decimals e.g. 42, -3.50
+	TYPE_DATE // ISO dates e.g. 2020-04-30
+} column_type_t;
+
+/* Type definition */
+typedef struct typed_column typed_column_t;
+
+/* Initialize a new typed column, in sampling state
+ * @return ptr to new typed column or NULL if error
+ */
+typed_column_t *typed_column_new(void);
+
+/* Get type of column
+ * @param tc typed column of interest
+ * @return type, TYPE_STRING if error
+ */
+column_type_t typed_column_get_type(typed_column_t *tc);
+
+/* Count a cell toward deciding column's type; only while sampling
+ * @param tc typed column to modify
+ * @param s cell
+ * @param len length of cell
+ */
+void typed_column_sample(typed_column_t *tc, const char *s, size_t len);
+
+/* Decide on column's type from cells sampled, switching out of sampling state
+ * @param tc typed column to modify
+ * @param allowed false to make column TYPE_STRING no matter what (e.g. typed values could be null words)
+ * @return type decided on
+ */
+column_type_t typed_column_decide(typed_column_t *tc, bool allowed);
+
+/* Give up on column being typed after all, dropping anything counted; column becomes TYPE_STRING
+ * @param tc typed column to modify
+ */
+void typed_column_abandon(typed_column_t *tc);
+
+/* Count a cell if it fits column's type
+ * @param tc typed column to modify
+ * @param s cell
+ * @param len length of cell
+ * @param count how much to add to cell's freq (1 for a single cell)
+ * @return true if counted here, false if cell doesn't fit (caller should count it as a string)
+ */
+bool typed_column_add(typed_column_t *tc, const char *s, size_t len, float count);
+
+/* Get freq of a cell counted here
+ * @param tc typed column of interest
+ * @param s cell
+ * @param len length of cell
+ * @return freq, 0 if not counted here
+ */
+float typed_column_get_count(typed_column_t *tc, const char *s, size_t len);
+
+/* Get # unique values counted here
+ * @param tc typed column of interest
+ * @return # unique values or -1 if error
+ */
+int typed_column_get_keys_n(typed_column_t *tc);
+
+/* Get # bytes typed column takes up
+ * @param tc typed column of interest
+ * @return # bytes, 0 if error
+ */
+size_t typed_column_get_size(typed_column_t *tc);
+
+/* Iterate through every value counted, printed back as a string, applying func to each
+ * Same func as hashtable_iterate takes, so the same callbacks work for both
+ * @param tc typed column to iterate through
+ * @param data whatever user wants to pass to func
+ * @param func function applied to every value; val is float ptr to freq, can be modified
+ */
+void typed_column_iterate(typed_column_t *tc, void *data, void (*func)(void *data, const char *key, void *val));
+
+/* Like typed_column_iterate, but only for values whose freq is at most max_count
+ * Values seen more often than that aren't even printed back
+ * @param tc typed column to iterate through
+ * @param max_count highest freq to apply func to
+ * @param data whatever user wants to pass to func
+ * @param func function applied to every value w/ low enough freq
+ */
+void typed_column_iterate_rare(typed_column_t *tc, float max_count, void *data, void (*func)(void *data, const char *key, void *val));
+
+/* Scales every freq by factor, dropping values whose freq falls below min_count
+ * @param tc typed column to modify
+ * @param factor what to multiply freqs by
+ * @param min_count lowest freq to keep
+ */
+void typed_column_decay(typed_column_t *tc, float factor, float min_count);
+
+/* Drops every value counted (& shrinks table back down), keeping column's type
+ * @param tc typed column to empty
+ * @return exit status (4 if table couldn't be made again; column's then TYPE_STRING)
+ */
+int typed_column_clear(typed_column_t *tc);
+
+/* Frees up typed column
+ * @param tc typed column to free
+ */
+void typed_column_free(typed_column_t *tc);
+
+#endif
@@ -0,0 +1,255 @@
+/* UTF-8 helpers' .c file
+ * See .h file for more details on each function
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "utf8.h"
+
+#define ONES 0x0101010101010101ULL
+#define HIGHS (ONES * 0x80) // High bit of every byte
+
+/* Local types */
+
+// Range of code points folded the same way
+typedef struct fold_range {
+	uint32_t first;
+	uint32_t last;
+	int32_t delta; // Added to code point
+	bool pairs; // Only every other code point from first is uppercase (upper/lower pairs)
+} fold_range_t;
+
+// Uppercase & compatibility forms worth folding for null words, in order
+static const fold_range_t FOLDS[] = {
+	{0x00A0, 0x00A0, ' ' - 0x00A0, false}, // No-break space
+	{0x00C0, 0x00D6, 32, false}, // Latin-1
+	{0x00D8, 0x00DE, 32, false},
+	{0x0100, 0x012F, 1, true}, // Latin Extended-A
+	{0x0130, 0x0130, 'i' - 0x0130, false},
+	{0x0132, 0x0137, 1, true},
+	{0x0139, 0x0148, 1, true},
+	{0x014A, 0x0177, 1, true},
+	{0x0178, 0x0178, 0x00FF - 0x0178, false},
+	{0x0179, 0x017E, 1, true},
+	{0x0391, 0x03A1, 32, false}, // Greek
+	{0x03A3, 0x03AB, 32, false},
+	{0x03C2, 0x03C2, 1, false}, // Final sigma
+	{0x0400, 0x040F, 80, false}, // Cyrillic
+	{0x0410, 0x042F, 32, false},
+	{0x0460, 0x0481, 1, true},
+	{0x048A, 0x04BF, 1, true},
+	{0x1680, 0x1680, ' ' - 0x1680, false}, // Unicode spaces
+	{0x1E00, 0x1E95, 1, true}, // Latin Extended Additional (e.g. Vietnamese)
+	{0x1EA0, 0x1EFF, 1, true},
+	{0x2000, 0x200A, ' ' - 0x2000, false},
+	{0x202F, 0x202F, ' ' - 0x202F, false},
+	{0x205F, 0x205F, ' ' - 0x205F, false},
+	{0x3000, 0x3000, ' ' - 0x3000, false}, // Ideographic space
+	{0xFF01, 0xFF5E, 0x21 - 0xFF01, false} // Full-width ASCII
+};
+
+// Local function declaration
+static uint64_t ascii_lower8(uint64_t w);
+static int ascii_spaces8(uint64_t w);
+static size_t decode(const unsigned char *s, size_t len, uint32_t *cp);
+static size_t encode(uint32_t cp, char *out);
+static uint32_t fold_cp(uint32_t cp);
+
+size_t utf8_fold(const char *s, size_t len, char *out)
+{
+	size_t i = 0; // Next byte to read
+	size_t j = 0; // Next byte to write, never past i so out can be s
+
+	if (s == NULL || out == NULL) {
+		return 0;
+	}
+	while (i < len) {
+		uint64_t w;
+		uint32_t cp;
+		size_t n;
+
+		if (i + 8 <= len) { // 8 ASCII bytes at a time while they last
+			memcpy(&w, s + i, 8);
+			if ((w & HIGHS) == 0) {
+				w = ascii_lower8(w);
+				memmove(out + j, &w, 8);
+				i += 8;
+				j += 8;
+				continue;
+			}
+		}
+
+		unsigned char c = (unsigned char)s[i];
+		if (c < 0x80) {
+			out[j++] = (c >= 'A' && c <= 'Z') ? (char)(c + 32) : (char)c;
+			i++;
+		}
+		else if ((n = decode((const unsigned char *)s + i, len - i, &cp)) == 0) { // Not UTF-8, leave as is
+			out[j++] = (char)c;
+			i++;
+		}
+		else {
+			i += n;
+			j += encode(fold_cp(cp), out + j);
+		}
+	}
+	return j;
+}
+
+int utf8_word_count(const char *s, size_t len)
+{
+	int c = 1; // Account for 1st word w/ no preceding whitespace
+	size_t i = 0;
+
+	if (s == NULL) {
+		return 0;
+	}
+	while (i < len) {
+		uint64_t w;
+		uint32_t cp;
+		size_t n;
+
+		if (i + 8 <= len) {
+			memcpy(&w, s + i, 8);
+			if ((w & HIGHS) == 0) {
+				c += ascii_spaces8(w);
+				i += 8;
+				continue;
+			}
+		}
+
+		unsigned char b = (unsigned char)s[i];
+		if (b < 0x80) {
+			c += (b == ' ' || (b >= '\t' && b <= '\r'));
+			i++;
+		}
+		else if ((n = decode((const unsigned char *)s + i, len - i, &cp)) == 0) {
+			i++;
+		}
+		else {
+			c += (cp != ' ' && fold_cp(cp) == ' '); // Every Unicode space folds to ' '
+			i += n;
+		}
+	}
+	return c;
+}
+
+/* Lowercases 8 ASCII bytes at once: high bit of a byte ends up set after adding 0x80-'A' only if it's >= 'A',
+ * & after adding 0x80-'Z'-1 only if it's > 'Z'; never carries into next byte since every byte < 0x80
+ * @param w 8 ASCII bytes
+ * @return same bytes w/ A-Z lowercased
+ */
+static uint64_t ascii_lower8(uint64_t w)
+{
+	uint64_t ge_a = w + ONES * (0x80 - 'A');
+	uint64_t gt_z = w + ONES * (0x80 - 'Z' - 1);
+	return w | (((ge_a ^ gt_z) & HIGHS) >> 2); // 0x80 >> 2 is 0x20, the case bit
+}
+
+/* Counts ASCII whitespace (' ', \t \n \v \f \r) in 8 bytes at once, same trick as ascii_lower8
+ * @param w 8 ASCII bytes
+ * @return # whitespace bytes
+ */
+static int ascii_spaces8(uint64_t w)
+{
+	uint64_t x = w ^ (ONES * ' '); // Byte's 0 where w had a space
+	uint64_t is_space = ~(((x & ~HIGHS) + ~HIGHS) | x) & HIGHS;
+	uint64_t ge_tab = (w + ONES * (0x80 - '\t')) & HIGHS;
+	uint64_t gt_cr = (w + ONES * (0x80 - '\r' - 1)) & HIGHS;
+	uint64_t mask = is_space | (ge_tab & ~gt_cr);
+	return (int)((((mask >> 7) * ONES) >> 56) & 0xFF); // Sum of every byte ends up in top byte
+}
+
+/* Decodes a single UTF-8 char
+ * @param s bytes, 1st is >= 0x80
+ * @param len # bytes left
+ * @param cp filled in w/ code point
+ * @return # bytes in char, 0 if not valid UTF-8
+ */
+static size_t decode(const unsigned char *s, size_t len, uint32_t *cp)
+{
+	size_t n;
+	uint32_t min; // Smallest code point that needs n bytes, anything less is overlong
+
+	if (s[0] >= 0xC2 && s[0] <= 0xDF) {
+		n = 2;
+		*cp = s[0] & 0x1F;
+		min = 0x80;
+	}
+	else if (s[0] >= 0xE0 && s[0] <= 0xEF) {
+		n = 3;
+		*cp = s[0] & 0x0F;
+		min = 0x800;
+	}
+	else if (s[0] >= 0xF0 && s[0] <= 0xF4) {
+		n = 4;
+		*cp = s[0] & 0x07;
+		min = 0x10000;
+	}
+	else {
+		return 0;
+	}
+	if (len < n) {
+		return 0;
+	}
+	for (size_t k = 1; k < n; k++) {
+		if ((s[k] & 0xC0) != 0x80) {
+			return 0;
+		}
+		*cp = (*cp << 6) | (s[k] & 0x3F);
+	}
+	if (*cp < min || *cp > 0x10FFFF || (*cp >= 0xD800 && *cp <= 0xDFFF)) {
+		return 0;
+	}
+	return n;
+}
+
+/* Encodes a code point as UTF-8
+ * @param cp code point
+ * @param out room for up to 4 bytes
+ * @return # bytes written
+ */
+static size_t encode(uint32_t cp, char *out)
+{
+	if (cp < 0x80) {
+		out[0] = (char)cp;
+		return 1;
+	}
+	if (cp < 0x800) {
+		out[0] = (char)(0xC0 | (cp >> 6));
+		out[1] = (char)(0x80 | (cp & 0x3F));
+		return 2;
+	}
+	if (cp < 0x10000) {
+		out[0] = (char)(0xE0 | (cp >> 12));
+		out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+		out[2] = (char)(0x80 | (cp & 0x3F));
+		return 3;
+	}
+	out[0] = (char)(0xF0 | (cp >> 18));
+	out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+	out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+	out[3] = (char)(0x80 | (cp & 0x3F));
+	return 4;
+}
+
+/* Folds a single non-ASCII code point, through FOLDS table
+ * @param cp code point
+ * @return folded code point (cp itself if nothing to fold)
+ */
+static uint32_t fold_cp(uint32_t cp)
+{
+	for (size_t k = 0; k < sizeof(FOLDS) / sizeof(FOLDS[0]) && cp >= FOLDS[k].first; k++) {
+		if (cp <= FOLDS[k].last) {
+			if (FOLDS[k].pairs && (cp - FOLDS[k].first) % 2 != 0) { // Already lowercase half of pair
+				return cp;
+			}
+			cp = (uint32_t)((int32_t)cp + FOLDS[k].delta);
+			return (cp >= 'A' && cp <= 'Z') ? cp + 32 : cp; // Full-width uppercase ends up ASCII uppercase
+		}
+	}
+	return cp;
+}
@@ -0,0 +1,28 @@
+/* UTF-8 case folding & whitespace, for comparing fields to null words w/o depending on locale
+ * Pure ASCII runs are done 8 bytes at a time; multibyte chars go through small tables
+ */
+
+#ifndef __UTF8_H
+#define __UTF8_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Case fold & normalize a string: uppercase to lowercase (ASCII, Latin-1, Latin Extended-A, Greek, Cyrillic),
+ * full-width forms (e.g. U+FF2E) to their ASCII equivalents, other Unicode spaces to ' '
+ * Invalid UTF-8 is copied as is; folded string is never longer than original
+ * @param s string to fold
+ * @param len # bytes in s
+ * @param out filled in w/ folded string, room for len bytes (can be s itself)
+ * @return # bytes in out
+ */
+size_t utf8_fold(const char *s, size_t len, char *out);
+
+/* Count words in a string as 1 + # whitespace chars (ASCII whitespace, no-break & other Unicode spaces)
+ * @param s string
+ * @param len # bytes in s
+ * @return # words
+ */
+int utf8_word_count(const char *s, size_t len);
+
+#endif
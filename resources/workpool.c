@@ -0,0 +1,165 @@
+/* Thread pool's .c file
+ * See .h file for more details on each function
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "workpool.h"
+
+/* Local types */
+
+// Range of task #s still to be run by one worker; owner takes from front, thieves from back
+typedef struct deque {
+	pthread_mutex_t lock;
+	int lo; // Next task owner runs
+	int hi; // One past last task still in range
+} deque_t;
+
+// Shared by all workers
+typedef struct pool {
+	deque_t *deques; // One per worker
+	int threads_n;
+	void *data;
+	void (*func)(void *data, int task);
+} pool_t;
+
+// Argument to each thread
+typedef struct worker {
+	pool_t *pool;
+	int id; // Index of worker's own deque
+} worker_t;
+
+// Local function declaration
+static void *work(void *arg);
+static int take_own(deque_t *deque);
+static int steal(pool_t *pool, int id);
+
+int workpool_run(int tasks_n, int threads_n, void *data, void (*func)(void *data, int task))
+{
+	if (tasks_n < 0 || func == NULL) {
+		return 2;
+	}
+
+	if (threads_n > tasks_n) {
+		threads_n = tasks_n;
+	}
+	if (threads_n <= 1) { // Not worth spawning anything
+		for (int i = 0; i < tasks_n; i++) {
+			(*func)(data, i);
+		}
+		return 0;
+	}
+
+	pool_t pool;
+	pthread_t *threads = calloc(threads_n, sizeof(pthread_t));
+	worker_t *workers = calloc(threads_n, sizeof(worker_t));
+	pool.deques = calloc(threads_n, sizeof(deque_t));
+	if (threads == NULL || workers == NULL || pool.deques == NULL) {
+		free(threads);
+		free(workers);
+		free(pool.deques);
+		return 4;
+	}
+	pool.threads_n = threads_n;
+	pool.data = data;
+	pool.func = func;
+
+	// Split tasks evenly into contiguous ranges to start w/
+	for (int i = 0; i < threads_n; i++) {
+		pthread_mutex_init(&pool.deques[i].lock, NULL);
+		pool.deques[i].lo = (int)((long)tasks_n * i / threads_n);
+		pool.deques[i].hi = (int)((long)tasks_n * (i+1) / threads_n);
+		workers[i].pool = &pool;
+		workers[i].id = i;
+	}
+
+	// Calling thread works as worker 0 rather than sitting idle
+	int started = 1;
+	for (int i = 1; i < threads_n; i++) {
+		if (pthread_create(&threads[i], NULL, work, &workers[i]) != 0) {
+			break; // Remaining ranges get stolen by those running
+		}
+		started++;
+	}
+	work(&workers[0]);
+	for (int i = 1; i < started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	for (int i = 0; i < threads_n; i++) {
+		pthread_mutex_destroy(&pool.deques[i].lock);
+	}
+	free(pool.deques);
+	free(workers);
+	free(threads);
+	return 0;
+}
+
+int workpool_default_threads(void)
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n < 1) {
+		return 1;
+	}
+	return (int)n;
+}
+
+/* Thread body: run own tasks, then steal until nothing left anywhere
+ * @param arg worker_t ptr
+ * @return NULL
+ */
+static void *work(void *arg)
+{
+	worker_t *worker = (worker_t *)arg;
+	pool_t *pool = worker->pool;
+	int task;
+
+	while ((task = take_own(&pool->deques[worker->id])) >= 0 || (task = steal(pool, worker->id)) >= 0) {
+		(*pool->func)(pool->data, task);
+	}
+	return NULL;
+}
+
+/* Take next task from front of a worker's own range
+ * @param deque worker's range
+ * @return task # or -1 if range empty
+ */
+static int take_own(deque_t *deque)
+{
+	int task = -1;
+
+	pthread_mutex_lock(&deque->lock);
+	if (deque->lo < deque->hi) {
+		task = deque->lo++;
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return task;
+}
+
+/* Take a task from back of some other worker's range
+ * @param pool pool of workers
+ * @param id thief's own index, skipped
+ * @return task # or -1 if every range is empty
+ */
+static int steal(pool_t *pool, int id)
+{
+	for (int i = 1; i < pool->threads_n; i++) {
+		deque_t *victim = &pool->deques[(id + i) % pool->threads_n];
+		int task = -1;
+
+		pthread_mutex_lock(&victim->lock);
+		if (victim->lo < victim->hi) {
+			task = --victim->hi;
+		}
+		pthread_mutex_unlock(&victim->lock);
+
+		if (task >= 0) {
+			return task;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,24 @@
+/* Small thread pool for running independent numbered tasks in parallel
+ * Each worker owns a contiguous range of tasks and steals from others when its own runs dry,
+ * so a few very large tasks (e.g. huge columns) don't leave the other threads idle
+ */
+
+#ifndef __WORKPOOL_H
+#define __WORKPOOL_H
+
+/* Run func once for every task # in [0, tasks_n), spread over threads_n threads
+ * Returns only once every task has finished
+ * @param tasks_n number of tasks
+ * @param threads_n number of threads to use; <= 1 runs everything in calling thread
+ * @param data whatever user wants to pass to func, shared by all tasks
+ * @param func function applied to every task #
+ * @return exit status
+ */
+int workpool_run(int tasks_n, int threads_n, void *data, void (*func)(void *data, int task));
+
+/* Get default number of threads to use (# of online processors)
+ * @return thread #, at least 1
+ */
+int workpool_default_threads(void);
+
+#endif
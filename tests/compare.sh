@@ -0,0 +1,72 @@
+#!/bin/sh
+# End-to-end checks of find_null, run by make test from root directory
+# Outputs are checked against those of the original find_null (before any of the parallel, library & dialect work),
+# saved in tests/expected (or checked by hand where it crashes, noted below), & runs that should agree w/ each other
+# (e.g. 1 thread vs many) are checked against each other
+
+NULLS=resources/nulls
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+failed=0
+
+# Null words in each column, one "col word" per line, sorted; original reports them in table order
+sets() {
+	awk '/^COLUMN/ {col = $2; next} {n = split($0, w, ", "); for (i = 1; i <= n; i++) if (w[i] != "" && w[i] != " ") print col, w[i]}' "$1" | sort
+}
+
+# Check $TMP/name.out has same null words as tests/expected/name.out
+expect() {
+	sets "$TMP/$1.out" > "$TMP/$1.got"
+	sets "tests/expected/$1.out" > "$TMP/$1.want"
+	if cmp -s "$TMP/$1.want" "$TMP/$1.got"; then
+		echo "ok   $1"
+	else
+		echo "FAIL $1 (vs expected)"
+		diff "$TMP/$1.want" "$TMP/$1.got" | head -10
+		failed=1
+	fi
+}
+
+# Check 2 files in $TMP are exactly the same
+same() {
+	if cmp -s "$TMP/$2" "$TMP/$3"; then
+		echo "ok   $1"
+	else
+		echo "FAIL $1 ($2 vs $3)"
+		diff "$TMP/$2" "$TMP/$3" | head -10
+		failed=1
+	fi
+}
+
+# Synthetic data: typed, low & high cardinality, quoted & non-ASCII columns
+./gen_csv 20000 > "$TMP/gen.csv"
+./find_null $NULLS "$TMP/gen.csv" 20000 > "$TMP/gen.out"
+expect gen
+./gen_csv 3000 7 > "$TMP/small.csv"
+./find_null $NULLS "$TMP/small.csv" 3000 > "$TMP/small.out"
+expect small
+
+# Rare words that aren't pre-defined, empty fields
+./find_null $NULLS tests/data/mixed.csv 400 > "$TMP/mixed.out"
+expect mixed
+
+# Comma file w/ ragged rows & a column of x;y values, which mustn't be taken for semicolon-separated
+awk 'BEGIN {print "id,pair,val,extra"; for (i = 1; i <= 4000; i++) printf (i % 2) ? "%d,x;y,%s\n" : "%d,x;y,%s,e%d\n", i, (i % 400 == 7) ? "N/A" : i * 3, i}' > "$TMP/semi.csv"
+./find_null $NULLS "$TMP/semi.csv" 4000 > "$TMP/semi.out" 2> /dev/null
+expect semi
+
+# Fields of 10+ bytes only count if they're a whole null word: "NÃO INFORMADO" does, "nothing yet" doesn't
+# Checked by hand, as original crashes on it
+printf 'não informado\nnothing\n' > "$TMP/long.nulls"
+awk 'BEGIN {print "id,a,b"; for (i = 1; i <= 200; i++) printf "%d,%s,%s\n", i, (i % 50 == 1) ? "NÃO INFORMADO" : "v" (i % 7), (i % 50 == 3) ? "nothing yet" : (i % 50 == 4) ? "Nothing" : "w" (i % 5)}' > "$TMP/long.csv"
+./find_null "$TMP/long.nulls" "$TMP/long.csv" 200 > "$TMP/long.out"
+expect long
+
+# Stray quote in an unquoted field (12") & quoted newlines in a file big enough to be split: any # threads
+# has to give what 1 does, warnings included
+awk 'BEGIN {srand(7); print "id,desc,code,val"; for (i = 1; i <= 600000; i++) {r = int(rand() * 1000); d = (r < 1 || i == 5) ? "12\" pizza" : (r < 60) ? "\"multi\nline, text " i "\"" : "item" int(rand() * 300); printf "%d,%s,c%d,%s\n", i, d, int(rand() * 50), (r % 97 == 5) ? "N/A" : int(rand() * 100000)}}' > "$TMP/stray.csv"
+./find_null $NULLS "$TMP/stray.csv" 600000 1 > "$TMP/stray1.out" 2>&1
+./find_null $NULLS "$TMP/stray.csv" 600000 8 > "$TMP/stray8.out" 2>&1
+same stray-threads stray1.out stray8.out
+
+exit $failed
@@ -0,0 +1,23 @@
+/* Tiny harness for unit checks, one program per module in tests/
+ * A failed check prints where it is & what failed, & program exits w/ status 1 once all checks are run
+ */
+
+#ifndef __TEST_H
+#define __TEST_H
+
+#include <stdio.h>
+
+static int checks_failed = 0;
+
+// Check cond holds, carrying on either way
+#define CHECK(cond) do { \
+	if (!(cond)) { \
+		fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		checks_failed++; \
+	} \
+} while (0)
+
+// Prints how checks went & gives exit status for main
+#define CHECKS_DONE(name) (printf("%s %s\n", (checks_failed == 0) ? "ok  " : "FAIL", name), (checks_failed == 0) ? 0 : 1)
+
+#endif
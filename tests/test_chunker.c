@@ -0,0 +1,142 @@
+/* Unit checks for splitting csv files on row boundaries (resources/chunker.h)
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chunker.h"
+#include "test.h"
+
+#define MAX_CHUNKS 64
+
+// Function declaration
+bool splits_right(const char *buf, long size, int chunks_n, int threads_n);
+int split(const char *buf, int chunks_n, long *bounds, long *header_end);
+long next_row_end(const char *buf, long size, long from);
+
+/* Runs every check
+ * @return 0 if all passed, 1 if not
+ */
+int main(void)
+{
+	long bounds[MAX_CHUNKS+1];
+	long header_end;
+
+	// Small files, cut at 1st row end at or after each even split
+	CHECK(split("a,b\n1,2\n3,4\n5,6\n", 2, bounds, &header_end) == 0);
+	CHECK(header_end == 4 && bounds[0] == 0 && bounds[1] == 8 && bounds[2] == 16);
+	CHECK(split("a,b\n\"x\ny\",2\n\"z\n\",3\n", 3, bounds, &header_end) == 0);
+	CHECK(header_end == 4 && bounds[1] == 12 && bounds[2] == 12 && bounds[3] == 19); // Newlines inside quotes skipped, 1 piece empty
+	CHECK(split("\"a\nb\",c\n1,2\n", 1, bounds, &header_end) == 0);
+	CHECK(header_end == 8 && bounds[0] == 0 && bounds[1] == 12);
+
+	// 1 row, no newline, empty file
+	CHECK(split("a,b,c", 2, bounds, &header_end) == 0);
+	CHECK(header_end == 5 && bounds[1] == 5 && bounds[2] == 5);
+	CHECK(split("", 3, bounds, &header_end) == 0);
+	CHECK(header_end == 0 && bounds[3] == 0);
+
+	// Bad args
+	CHECK(chunker_split(NULL, 1, 1, '"', 1, bounds, &header_end) == 2);
+	CHECK(chunker_split(stdin, 1, 0, '"', 1, bounds, &header_end) == 2);
+
+	// Bigger file w/ quoted newlines & doubled quotes, segments read in more than 1 buffer, any # pieces & threads
+	long size = 0;
+	long cap = 3000000;
+	char *buf = malloc(cap);
+	CHECK(buf != NULL);
+	if (buf != NULL) {
+		size += sprintf(buf, "id,note,val\n");
+		for (int i = 0; size < cap - 100; i++) {
+			if (i % 7 == 0) {
+				size += sprintf(buf + size, "%d,\"line\n%d, said \"\"hi\"\"\n\",%d\n", i, i, i * 3);
+			}
+			else {
+				size += sprintf(buf + size, "%d,plain %d,%d\n", i, i % 13, i * 3);
+			}
+		}
+		int chunks[] = {1, 2, 3, 7, 16, MAX_CHUNKS};
+		for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+			CHECK(splits_right(buf, size, chunks[c], 1));
+			CHECK(splits_right(buf, size, chunks[c], 4));
+		}
+		free(buf);
+	}
+
+	return CHECKS_DONE("chunker");
+}
+
+/* Whether chunker cuts a buffer where a parser reading it in order would find 1st row end at or after each split
+ * @param buf csv contents
+ * @param size # bytes in buf
+ * @param chunks_n # pieces wanted
+ * @param threads_n # threads to scan w/
+ * @return true if all bounds & header end are right
+ */
+bool splits_right(const char *buf, long size, int chunks_n, int threads_n)
+{
+	long bounds[MAX_CHUNKS+1];
+	long header_end;
+	FILE *fp = tmpfile();
+	bool right;
+
+	if (fp == NULL || fwrite(buf, 1, size, fp) != (size_t)size || fflush(fp) != 0) {
+		if (fp != NULL) {
+			fclose(fp);
+		}
+		return false;
+	}
+	right = chunker_split(fp, size, chunks_n, '"', threads_n, bounds, &header_end) == 0;
+	fclose(fp);
+
+	right = right && header_end == next_row_end(buf, size, 0) && bounds[0] == 0 && bounds[chunks_n] == size;
+	for (int k = 1; k < chunks_n && right; k++) {
+		long start = size / chunks_n * k - 1;
+		right = bounds[k] == next_row_end(buf, size, start < 0 ? 0 : start);
+	}
+	return right;
+}
+
+/* Splits a string written out to a temp file, 2 threads
+ * @param buf csv contents
+ * @param chunks_n # pieces wanted
+ * @param bounds filled in as by chunker_split
+ * @param header_end filled in as by chunker_split
+ * @return exit status, 4 if temp file failed
+ */
+int split(const char *buf, int chunks_n, long *bounds, long *header_end)
+{
+	long size = (long)strlen(buf);
+	FILE *fp = tmpfile();
+	int stat = 4;
+
+	if (fp != NULL) {
+		if (fwrite(buf, 1, size, fp) == (size_t)size && fflush(fp) == 0) {
+			stat = chunker_split(fp, size, chunks_n, '"', 2, bounds, header_end);
+		}
+		fclose(fp);
+	}
+	return stat;
+}
+
+/* Finds 1st row end at or after an offset, tracking quotes from start of buffer
+ * @param buf csv contents
+ * @param size # bytes in buf
+ * @param from offset to look from
+ * @return offset just past newline ending row, size if none
+ */
+long next_row_end(const char *buf, long size, long from)
+{
+	bool quoted = false;
+
+	for (long i = 0; i < size; i++) {
+		if (buf[i] == '"') {
+			quoted = !quoted;
+		}
+		else if (buf[i] == '\n' && !quoted && i >= from) {
+			return i + 1;
+		}
+	}
+	return size;
+}
@@ -0,0 +1,76 @@
+/* Unit checks for csv dialect guessing & options (resources/dialect.h)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dialect.h"
+#include "test.h"
+
+// Function declaration
+dialect_t sniff(const char *buf);
+
+/* Runs every check
+ * @return 0 if all passed, 1 if not
+ */
+int main(void)
+{
+	dialect_t d;
+
+	// Plain files of each delimiter
+	CHECK(sniff("a,b,c\n1,2,3\n4,5,6\n").delim == ',');
+	CHECK(sniff("a\tb\tc\n1\t2\t3\n4\t5\t6\n").delim == '\t');
+	CHECK(sniff("a;b;c\n1,5;2;3\n4;5,5;6\n").delim == ';'); // Decimal commas
+	CHECK(sniff("a|b\n1|2\n").delim == '|');
+	CHECK(sniff("a,b,c").delim == ','); // 1 line, no newline
+
+	// Delimiter inside quotes doesn't count
+	CHECK(sniff("name\tnote\n\"x\"\t\"a, b, c\"\n\"y\"\t\"d, e\"\n").delim == '\t');
+
+	// Comma's kept unless another delimiter's strictly better on both lines & fields
+	CHECK(sniff("id,pair,val,extra\n1,x;y,3\n2,x;y,6,e\n3,x;y,9\n4,x;y,12,e\n").delim == ',');
+	CHECK(sniff("id,pair;x,val\n1,x;y,3\n2,x;y,6\n").delim == ',');
+	CHECK(sniff("name,first\tage\tcity\nsmith, j\t40\tparis\njones\t35\trome\n").delim == '\t');
+
+	// Delimiter has to be in header
+	CHECK(sniff("id,name\n1;2;3;4,x\n5;6;7;8,y\n").delim == ',');
+	CHECK(sniff("single\nx\ny\n").delim == ',');
+
+	// Ragged rows don't get a say
+	CHECK(sniff("a;b;c\n1;2;3\n1;2\n1;2;3;4\n1;2;3\n").delim == ';');
+
+	// Quote char
+	CHECK(sniff("a,b\n'x, y',2\n'z',3\n").quote == '\'');
+	CHECK(sniff("a,b\nit's,2\n\"q\",3\n").quote == '"');
+
+	// Encoding
+	CHECK(sniff("a,b\nna\xC3\xAFve,2\n").encoding == ENCODING_UTF8);
+	CHECK(sniff("a,b\nna\xEFve,2\n").encoding == ENCODING_LATIN1);
+	CHECK(sniff("\xEF\xBB\xBF" "a;b\n1;2\n").delim == ';');
+
+	// Options
+	dialect_default(&d);
+	CHECK(dialect_parse_opt('F', "tab", &d) == 0 && d.delim == '\t');
+	CHECK(dialect_parse_opt('F', ":", &d) == 0 && d.delim == ':');
+	CHECK(dialect_parse_opt('F', "::", &d) == 1);
+	CHECK(dialect_parse_opt('Q', "'", &d) == 0 && d.quote == '\'');
+	CHECK(dialect_parse_opt('E', "latin1", &d) == 0 && d.encoding == ENCODING_LATIN1);
+	CHECK(dialect_parse_opt('E', "ebcdic", &d) == 1);
+	CHECK(dialect_parse_opt('P', "strict", &d) == 0 && d.strict);
+	CHECK(dialect_parse_opt('F', NULL, &d) == 2);
+
+	return CHECKS_DONE("dialect");
+}
+
+/* Guesses dialect of a string, starting from default
+ * @param buf null-terminated start of data
+ * @return dialect guessed
+ */
+dialect_t sniff(const char *buf)
+{
+	dialect_t d;
+
+	dialect_default(&d);
+	dialect_sniff(buf, strlen(buf), &d);
+	return d;
+}
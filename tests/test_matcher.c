@@ -0,0 +1,115 @@
+/* Unit checks for null words matcher (resources/matcher.h)
+ */
+
+#define _POSIX_C_SOURCE 200809L // mkstemp
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "matcher.h"
+#include "test.h"
+
+// Function declaration
+size_t longest(const matcher_t *matcher, const char *text);
+matcher_t *load(const char *contents);
+
+/* Runs every check
+ * @return 0 if all passed, 1 if not
+ */
+int main(void)
+{
+	char *words[] = {"NULL", "n/a", "#N/A", "na", "nan", "-1"};
+	matcher_t *m = matcher_new(words, 6);
+
+	CHECK(m != NULL);
+	CHECK(matcher_get_words_n(m) == 6);
+	CHECK(matcher_get_max_len(m) == 4);
+
+	// Whole words, folded the same way fields are
+	CHECK(longest(m, "null") == 4);
+	CHECK(longest(m, "n/a") == 3);
+	CHECK(longest(m, "#n/a") == 4);
+	CHECK(longest(m, "nan") == 3);
+
+	// Words inside text, longest one wins where they overlap
+	CHECK(longest(m, "is null here") == 4);
+	CHECK(longest(m, "banana") == 3);
+	CHECK(longest(m, "xx#n/") == 0); // Just the start of a word
+	CHECK(longest(m, "-1.0") == 2);
+
+	// Nothing to find
+	CHECK(longest(m, "") == 0);
+	CHECK(longest(m, "hello") == 0);
+	CHECK(longest(m, "NULL") == 0); // Fields are folded before matching, so upper case never shows up
+	CHECK(matcher_longest(m, "null", 2) == 0); // Only len bytes looked at
+
+	// Words made up only of some chars
+	CHECK(matcher_has_word_of(m, "0123456789.-"));
+	CHECK(!matcher_has_word_of(m, "0123456789"));
+	matcher_free(m);
+
+	// No words at all
+	m = matcher_new(words, 0);
+	CHECK(m != NULL);
+	CHECK(longest(m, "null") == 0);
+	CHECK(!matcher_has_word_of(m, "0123456789.-"));
+	matcher_free(m);
+
+	// Loaded from file: 1 word per line, \r\n endings & blank lines skipped, no newline at end ok
+	m = load("NULL\r\n\n\nn/a\n  \nnão informado");
+	CHECK(m != NULL);
+	CHECK(matcher_get_words_n(m) == 4); // Line of spaces is a word
+	CHECK(matcher_get_max_len(m) == strlen("não informado"));
+	CHECK(longest(m, "null") == 4 && longest(m, "n/a") == 3 && longest(m, "null\r") == 4);
+	CHECK(longest(m, "não informado") == strlen("não informado"));
+	matcher_free(m);
+	CHECK(load("\n\n") == NULL); // No words in file counts as error
+
+	// Bad args
+	CHECK(matcher_load("no/such/file") == NULL);
+	CHECK(matcher_load(NULL) == NULL);
+	CHECK(matcher_new(NULL, 1) == NULL);
+	CHECK(matcher_longest(NULL, "null", 4) == 0);
+	CHECK(matcher_get_words_n(NULL) == -1);
+	CHECK(matcher_get_max_len(NULL) == 0);
+
+	return CHECKS_DONE("matcher");
+}
+
+/* Longest null word in a whole string
+ * @param matcher matcher to use
+ * @param text null-terminated string
+ * @return length of longest word found
+ */
+size_t longest(const matcher_t *matcher, const char *text)
+{
+	return matcher_longest(matcher, text, strlen(text));
+}
+
+/* Loads matcher from a temp file w/ given contents
+ * @param contents what to write to null file
+ * @return matcher or NULL if error
+ */
+matcher_t *load(const char *contents)
+{
+	char path[] = "/tmp/test_matcherXXXXXX";
+	int fd = mkstemp(path);
+	FILE *fp;
+	matcher_t *matcher = NULL;
+
+	if (fd < 0) {
+		return NULL;
+	}
+	if ((fp = fdopen(fd, "w")) == NULL) {
+		close(fd);
+	}
+	else {
+		if (fputs(contents, fp) >= 0 && fflush(fp) == 0) {
+			matcher = matcher_load(path);
+		}
+		fclose(fp);
+	}
+	unlink(path);
+	return matcher;
+}
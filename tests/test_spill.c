@@ -0,0 +1,163 @@
+/* Unit checks for spilling col freqs to disk & merging them back (resources/spill.h)
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spill.h"
+#include "test.h"
+
+#define MAX_SEEN 5000
+
+/* Local types */
+typedef struct seen {
+	char *keys[MAX_SEEN];
+	float counts[MAX_SEEN];
+	int n;
+	bool sorted; // Every key came after the one before it
+} seen_t;
+
+// Function declaration
+void record(void *data, const char *key, float count);
+void forget(seen_t *seen);
+float count_of(seen_t *seen, const char *key);
+
+/* Runs every check
+ * @return 0 if all passed, 1 if not
+ */
+int main(void)
+{
+	spill_file_t *file = spill_file_new();
+	spill_file_t *other = spill_file_new();
+	spill_runs_t *runs = spill_runs_new();
+	spill_runs_t *more = spill_runs_new();
+	seen_t seen = {.n = 0, .sorted = true};
+
+	CHECK(file != NULL && other != NULL && runs != NULL && more != NULL);
+	if (file == NULL || other == NULL || runs == NULL || more == NULL) {
+		return CHECKS_DONE("spill");
+	}
+
+	// No runs, nothing merged
+	CHECK(spill_runs_get_n(runs) == 0);
+	CHECK(spill_runs_merge(runs, &seen, record) == 0 && seen.n == 0);
+
+	// Runs come in unsorted & overlap; merged words come out once each, sorted, w/ freqs summed
+	spill_item_t a[] = {{"null", 3}, {"N/A", 1}, {"", 2}, {"zz", 1}};
+	spill_item_t b[] = {{"nan", 4}, {"null", 2}, {"", 1}};
+	spill_item_t c[] = {{"N/A", 5}, {"aaa", 1}};
+	CHECK(spill_runs_write(runs, file, a, 4) == 0);
+	CHECK(spill_runs_write(runs, file, b, 3) == 0);
+	CHECK(spill_runs_write(runs, file, c, 2) == 0);
+	CHECK(spill_runs_write(runs, file, c, 0) == 0); // Empty run
+	CHECK(spill_runs_get_n(runs) >= 3);
+	CHECK(spill_runs_merge(runs, &seen, record) == 0);
+	CHECK(seen.n == 6 && seen.sorted);
+	CHECK(count_of(&seen, "") == 3 && count_of(&seen, "N/A") == 6 && count_of(&seen, "aaa") == 1);
+	CHECK(count_of(&seen, "nan") == 4 && count_of(&seen, "null") == 5 && count_of(&seen, "zz") == 1);
+
+	// Merging only reads, so it can be done again
+	forget(&seen);
+	CHECK(spill_runs_merge(runs, &seen, record) == 0 && seen.n == 6 && count_of(&seen, "null") == 5);
+
+	// Scaling applies to runs written so far, not ones after
+	spill_runs_scale(runs, 0.5);
+	spill_item_t d[] = {{"null", 1}};
+	CHECK(spill_runs_write(runs, file, d, 1) == 0);
+	forget(&seen);
+	CHECK(spill_runs_merge(runs, &seen, record) == 0);
+	CHECK(count_of(&seen, "null") == 3.5 && count_of(&seen, "N/A") == 3);
+
+	// Runs adopted from another file are merged in too, src left empty
+	spill_item_t e[] = {{"null", 10}, {"new", 2}};
+	CHECK(spill_runs_write(more, other, e, 2) == 0);
+	CHECK(spill_runs_adopt(runs, more) == 0);
+	CHECK(spill_runs_get_n(more) == 0);
+	forget(&seen);
+	CHECK(spill_runs_merge(runs, &seen, record) == 0);
+	CHECK(seen.n == 7 && seen.sorted && count_of(&seen, "null") == 13.5 && count_of(&seen, "new") == 2);
+
+	// Many runs of many words, more than fit in one read buffer
+	spill_runs_t *big = spill_runs_new();
+	spill_item_t items[1000];
+	char words[1000][16];
+	CHECK(big != NULL);
+	for (int r = 0; r < 20 && big != NULL; r++) {
+		for (int i = 0; i < 1000; i++) {
+			sprintf(words[i], "w%05d", (i * 7 + r * 100) % 3000);
+			items[i].key = words[i];
+			items[i].count = 1;
+		}
+		CHECK(spill_runs_write(big, file, items, 1000) == 0);
+	}
+	forget(&seen);
+	CHECK(spill_runs_merge(big, &seen, record) == 0);
+	float total = 0;
+	for (int i = 0; i < seen.n; i++) {
+		total += seen.counts[i];
+	}
+	CHECK(seen.n == 3000 && seen.sorted && total == 20000);
+
+	forget(&seen);
+	spill_runs_free(big);
+	spill_runs_free(more);
+	spill_runs_free(runs);
+	spill_file_free(other);
+	spill_file_free(file);
+
+	// Bad args
+	CHECK(spill_runs_get_n(NULL) == -1);
+	CHECK(spill_runs_write(NULL, NULL, a, 1) != 0);
+
+	return CHECKS_DONE("spill");
+}
+
+/* Keeps a copy of a merged word & checks it's in order
+ * @param data seen_t ptr
+ * @param key word
+ * @param count word's freq
+ */
+void record(void *data, const char *key, float count)
+{
+	seen_t *seen = (seen_t *)data;
+
+	if (seen->n == MAX_SEEN) {
+		seen->sorted = false;
+		return;
+	}
+	if (seen->n > 0 && strcmp(seen->keys[seen->n-1], key) >= 0) {
+		seen->sorted = false;
+	}
+	if ((seen->keys[seen->n] = malloc(strlen(key)+1)) != NULL) {
+		strcpy(seen->keys[seen->n], key);
+		seen->counts[seen->n++] = count;
+	}
+}
+
+/* Frees every word kept so far
+ * @param seen words kept
+ */
+void forget(seen_t *seen)
+{
+	for (int i = 0; i < seen->n; i++) {
+		free(seen->keys[i]);
+	}
+	seen->n = 0;
+	seen->sorted = true;
+}
+
+/* Get freq merged for a word
+ * @param seen words kept
+ * @param key word of interest
+ * @return word's freq or -1 if it wasn't merged
+ */
+float count_of(seen_t *seen, const char *key)
+{
+	for (int i = 0; i < seen->n; i++) {
+		if (strcmp(seen->keys[i], key) == 0) {
+			return seen->counts[i];
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,162 @@
+/* Unit checks for typed columns (resources/typed_column.h): parsing cells 8 digits at a time
+ * & printing them back exactly as they were read
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "typed_column.h"
+#include "test.h"
+
+/* Local types */
+
+// Values printed back by iterating, to look through after
+typedef struct printed {
+	char keys[64][TYPED_KEY_MAX];
+	float counts[64];
+	int keys_n;
+} printed_t;
+
+// Function declaration
+typed_column_t *typed_as(const char *cell);
+bool add(typed_column_t *tc, const char *s);
+float printed_count(const printed_t *printed, const char *key);
+void print_key(void *data, const char *key, void *val);
+
+/* Runs every check
+ * @return 0 if all passed, 1 if not
+ */
+int main(void)
+{
+	// Numbers in canonical form, incl. ones long enough to go through 8 digits at a time
+	const char *numbers[] = {"0", "7", "42", "-3.50", "0.001", "-0.5", "12345678", "123456789", "-87654321.1",
+		"12345678901234567", "1234567890.1234567", "99999999"};
+	int numbers_n = sizeof(numbers) / sizeof(numbers[0]);
+	typed_column_t *tc = typed_as("42");
+	printed_t printed;
+
+	CHECK(typed_column_get_type(tc) == TYPE_NUMBER);
+	for (int i = 0; i < numbers_n; i++) {
+		CHECK(add(tc, numbers[i]));
+	}
+	CHECK(add(tc, "42"));
+	CHECK(typed_column_get_keys_n(tc) == numbers_n);
+	CHECK(typed_column_get_count(tc, "42", 2) == 2);
+	CHECK(typed_column_get_count(tc, "43", 2) == 0);
+
+	// Every one prints back just as it was
+	printed.keys_n = 0;
+	typed_column_iterate(tc, &printed, print_key);
+	CHECK(printed.keys_n == numbers_n);
+	for (int i = 0; i < numbers_n; i++) {
+		CHECK(printed_count(&printed, numbers[i]) > 0);
+	}
+	CHECK(printed_count(&printed, "42") == 2);
+
+	// Anything that wouldn't print back the same is left for string table
+	const char *not_numbers[] = {"", "-", "042", "-0", "-0.0", "1.", ".5", "+1", "1e5", "1.2.3", "12a45678", "1234567a",
+		"123456789012345678", "12345678.0123456789", "1,000", " 1"};
+	for (int i = 0; i < (int)(sizeof(not_numbers) / sizeof(not_numbers[0])); i++) {
+		CHECK(!add(tc, not_numbers[i]));
+	}
+	CHECK(typed_column_get_keys_n(tc) == numbers_n);
+
+	// Decaying & clearing
+	typed_column_decay(tc, 0.5f, 0.75f);
+	CHECK(typed_column_get_keys_n(tc) == 1); // Only 42 had freq 2
+	CHECK(typed_column_get_count(tc, "42", 2) == 1);
+	CHECK(typed_column_clear(tc) == 0);
+	CHECK(typed_column_get_keys_n(tc) == 0);
+	CHECK(typed_column_get_type(tc) == TYPE_NUMBER);
+	typed_column_free(tc);
+
+	// Dates
+	tc = typed_as("2020-04-30");
+	CHECK(typed_column_get_type(tc) == TYPE_DATE);
+	CHECK(add(tc, "2020-04-30"));
+	CHECK(add(tc, "1999-12-01"));
+	CHECK(!add(tc, "2020-13-01"));
+	CHECK(!add(tc, "2020-00-10"));
+	CHECK(!add(tc, "2020-4-30"));
+	CHECK(!add(tc, "2020/04/30"));
+	CHECK(!add(tc, "0000-00-00"));
+	CHECK(!add(tc, "42"));
+	printed.keys_n = 0;
+	typed_column_iterate(tc, &printed, print_key);
+	CHECK(printed.keys_n == 2);
+	CHECK(printed_count(&printed, "2020-04-30") == 1);
+	CHECK(printed_count(&printed, "1999-12-01") == 1);
+	typed_column_free(tc);
+
+	// Column w/ too few numbers or dates isn't typed
+	tc = typed_column_new();
+	for (int i = 0; i < TYPE_SAMPLE; i++) {
+		typed_column_sample(tc, (i % 5 == 0) ? "n/a" : "12", (i % 5 == 0) ? 3 : 2);
+	}
+	CHECK(typed_column_decide(tc, true) == TYPE_STRING);
+	CHECK(!add(tc, "12"));
+	typed_column_free(tc);
+
+	// Nor is one whose values could be null words
+	tc = typed_column_new();
+	typed_column_sample(tc, "12", 2);
+	CHECK(typed_column_decide(tc, false) == TYPE_STRING);
+	typed_column_free(tc);
+
+	return CHECKS_DONE("typed_column");
+}
+
+/* Makes a column that's decided on type of cell
+ * @param cell cell to sample
+ * @return typed column
+ */
+typed_column_t *typed_as(const char *cell)
+{
+	typed_column_t *tc = typed_column_new();
+
+	for (int i = 0; i < TYPE_SAMPLE; i++) {
+		typed_column_sample(tc, cell, strlen(cell));
+	}
+	typed_column_decide(tc, true);
+	return tc;
+}
+
+/* Counts a cell once
+ * @param tc typed column
+ * @param s null-terminated cell
+ * @return whether cell was counted in typed column
+ */
+bool add(typed_column_t *tc, const char *s)
+{
+	return typed_column_add(tc, s, strlen(s), 1);
+}
+
+/* Freq of a value printed back
+ * @param printed values printed back
+ * @param key value to look for
+ * @return freq, 0 if not printed back
+ */
+float printed_count(const printed_t *printed, const char *key)
+{
+	for (int i = 0; i < printed->keys_n; i++) {
+		if (strcmp(printed->keys[i], key) == 0) {
+			return printed->counts[i];
+		}
+	}
+	return 0;
+}
+
+/* Keeps a value printed back, for typed_column_iterate
+ * @param data printed_t ptr
+ * @param key value printed back
+ * @param val float ptr to freq
+ */
+void print_key(void *data, const char *key, void *val)
+{
+	printed_t *printed = (printed_t *)data;
+
+	if (printed->keys_n < 64) {
+		strcpy(printed->keys[printed->keys_n], key);
+		printed->counts[printed->keys_n++] = *(float *)val;
+	}
+}
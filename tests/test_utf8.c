@@ -0,0 +1,81 @@
+/* Unit checks for UTF-8 case folding & whitespace (resources/utf8.h)
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utf8.h"
+#include "test.h"
+
+// Function declaration
+bool folds_to(const char *s, const char *want);
+int words(const char *s);
+
+/* Runs every check
+ * @return 0 if all passed, 1 if not
+ */
+int main(void)
+{
+	// ASCII, short & long enough to go 8 bytes at a time, w/ the bytes right around A-Z left alone
+	CHECK(folds_to("NULL", "null"));
+	CHECK(folds_to("N/A", "n/a"));
+	CHECK(folds_to("NOT AVAILABLE AT ALL", "not available at all"));
+	CHECK(folds_to("@[`{AZaz09#<NA>", "@[`{azaz09#<na>"));
+	CHECK(folds_to("", ""));
+
+	// Latin-1 & Latin Extended, Greek, Cyrillic, mixed w/ ASCII past 8 bytes
+	CHECK(folds_to("NÃO INFORMADO", "não informado"));
+	CHECK(folds_to("ÉTÉ ÀÖØÞ", "été àöøþ"));
+	CHECK(folds_to("ŁÓDŹ Ÿİ", "łódź ÿi"));
+	CHECK(folds_to("KHÔNG CÓ DỮ LIỆU", "không có dữ liệu"));
+	CHECK(folds_to("ΚΑΝΕΝΑ ΣΤΟΙΧΕΙΟ", "κανενα στοιχειο"));
+	CHECK(folds_to("ΟΔΟΣ οδος", "οδοσ οδοσ")); // Final sigma folds like capital
+	CHECK(folds_to("НЕТ ДАННЫХ ЁЖ", "нет данных ёж"));
+
+	// Full-width forms & Unicode spaces
+	CHECK(folds_to("\xEF\xBC\xAE\xEF\xBC\xA1", "na")); // Full-width NA
+	CHECK(folds_to("n\xC2\xA0/\xE3\x80\x80" "a", "n / a"));
+
+	// Invalid UTF-8 (Latin-1 bytes, cut off sequence) copied as is
+	CHECK(folds_to("caf\xE9", "caf\xE9"));
+	CHECK(folds_to("X\xC3", "x\xC3"));
+
+	// Folding in place
+	char buf[] = "NÃO INFORMADO";
+	size_t len = utf8_fold(buf, strlen(buf), buf);
+	CHECK(len == strlen("não informado") && memcmp(buf, "não informado", len) == 0);
+	CHECK(utf8_fold(NULL, 3, buf) == 0);
+
+	// Words
+	CHECK(words("") == 1);
+	CHECK(words("n/a") == 1);
+	CHECK(words("not available") == 2);
+	CHECK(words("a\tb\nc d") == 4);
+	CHECK(words("no\xC2\xA0" "data\xE3\x80\x80here") == 3);
+	CHECK(words("one two three four five six seven eight nine") == 9);
+
+	return CHECKS_DONE("utf8");
+}
+
+/* Whether string folds to what's expected
+ * @param s string to fold
+ * @param want folded string expected
+ * @return true if folded string is want
+ */
+bool folds_to(const char *s, const char *want)
+{
+	char out[256];
+	size_t len = utf8_fold(s, strlen(s), out);
+
+	return len == strlen(want) && memcmp(out, want, len) == 0;
+}
+
+/* Count words in a whole string
+ * @param s null-terminated string
+ * @return # words
+ */
+int words(const char *s)
+{
+	return utf8_word_count(s, strlen(s));
+}